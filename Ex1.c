@@ -6,16 +6,49 @@
 
 // ----- INCLUDED LIBRARIES ----- //
 
+// GNU extensions (e.g., sched_setaffinity); it must precede every include.
+#define _GNU_SOURCE
 // Standard input-output library (e.g., fprintf).
 #include <stdio.h>
 // Time library (e.g., time, clock()).
 #include <time.h>
-// Standard library (e.g., rand, srand).
+// Standard library (e.g., malloc, free).
 #include <stdlib.h>
 // Boolean library (e.g., bool).
 #include <stdbool.h>
 // String library (e.g., memcpy, strcmp)
 #include <string.h>
+// POSIX threads library (e.g., pthread_create, pthread_mutex_lock).
+#include <pthread.h>
+// Atomic library (e.g., atomic_bool, atomic_load).
+#include <stdatomic.h>
+// Scheduling library (e.g., sched_yield).
+#include <sched.h>
+// POSIX library (e.g., sysconf).
+#include <unistd.h>
+// Limits library (e.g., INT_MAX).
+#include <limits.h>
+// Fixed-width integers library (e.g., uint64_t).
+#include <stdint.h>
+// Math library (e.g., log, exp).
+#include <math.h>
+// Intel intrinsics (e.g., _mm256_min_epi32, __rdtsc), only on x86.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
+// Benchmark harness (e.g., benchmarkNowNs, benchmarkComputeStats).
+#include "benchmark.h"
+// Hardware performance counters (e.g., perfCountersStart, perfCountersStop).
+#include "perfcounters.h"
+// Pseudo-random number generator (e.g., prngSeed, prngFill).
+#include "prng.h"
+// Verification of the outputs (e.g., verifyIsSorted, verifyMultisetHash).
+#include "verify.h"
+// Parallel experiment runner (e.g., runnerRun, runnerSeedJob).
+#include "runner.h"
+// Runtime parameters (e.g., optionsParse).
+#include "options.h"
 
 // ----- End INCLUDED LIBRARIES ----- //
 
@@ -30,15 +63,156 @@ typedef enum
   ONFILE			// On file.
 } outputEnumType;
 
+/**
+ * @brief Enumeration data type for the distribution of the input.
+ */
+typedef enum
+{
+  RANDOM,			// Uniformly random keys.
+  SORTED,			// Non-decreasing keys.
+  REVERSE_SORTED,		// Non-increasing keys.
+  K_SORTED,			// Every key at most kSortedDistance positions away from its sorted position.
+  FEW_UNIQUE			// Only fewUniqueKeys distinct keys.
+} inputEnumType;
+
 /**
  * @brief Pair data structure.
  */
 typedef struct
 {
-  clock_t time;			// Time needed to sort.
+  unsigned long long time;	// Time needed to sort, in nanoseconds.
   bool isSorted;		// Flag representing if the algorithm performed correctly its task.
+  perfValues_t counters;	// Hardware performance counters of the sort (see measureCounters).
 } pairType;
 
+/**
+ * @brief Jobs of one size of the main experiment: job j is the run exper = j - numWarmupRuns of every algorithm on
+ *        its own input.
+ */
+typedef struct
+{
+  int dim;			// Size of the inputs.
+  int row;			// Index of the size in the sweep (it makes the random streams of the jobs unique).
+  pairType *pairs;		// Results: numAlgorithms pairs for each job, in the order of algorithms.
+} sortJobsType;
+
+/**
+ * @brief Key+index pair: the key of a record and its position in the input, sorted in place of the record.
+ */
+typedef struct
+{
+  uint64_t key;			// Key of the record.
+  uint32_t index;		// Position of the record in the input.
+} keyIndexType;
+
+/**
+ * @brief Key extractor of the record sorts: returns the (unsigned 64-bit) key of a record.
+ */
+typedef uint64_t (*keyExtractorType) (const void *record);
+
+/**
+ * @brief Streaming top-k: max-heap of the k smallest elements seen so far.
+ */
+typedef struct
+{
+  int *heap;			// Max-heap of at most k elements.
+  int k;			// Number of smallest elements to be kept.
+  int size;			// Number of elements in the heap.
+} topKType;
+
+/**
+ * @brief Task of the work-stealing thread pool, used both for sorting and for merging.
+ */
+typedef struct taskType
+{
+  void (*run) (struct taskType *);        // Function executing the task.
+  atomic_bool done;                       // Flag set once the task has been executed.
+  struct threadPoolType *pool;            // Thread pool running the task.
+  int *D;                                 // Destination array.
+  int *S;                                 // Source (scratch) array.
+  int p;                                  // Left-end index of the input.
+  int q;                                  // Mid index of the input (merge only).
+  int r;                                  // Right-end index of the input.
+  int low;                                // First output index (merge only).
+  int high;                               // One past the last output index (merge only).
+} taskType;
+
+/**
+ * @brief Deque of tasks owned by a worker: the owner works on the tail, thieves steal from the head.
+ */
+typedef struct dequeType
+{
+  pthread_mutex_t lock;                   // Lock protecting the deque.
+  taskType **tasks;                       // Array of dequeCapacity pending tasks.
+  int head;                               // Index of the oldest task.
+  int tail;                               // One past the index of the newest task.
+  struct threadPoolType *pool;            // Thread pool the deque belongs to.
+} dequeType;
+
+/**
+ * @brief Work-stealing thread pool data structure.
+ */
+typedef struct threadPoolType
+{
+  int numWorkers;                         // Number of workers, including the calling thread.
+  pthread_t *threads;                     // Threads of the workers 1..numWorkers-1.
+  dequeType *deques;                      // One deque for each worker.
+  atomic_bool shutdown;                   // Flag telling the workers to terminate.
+} threadPoolType;
+
+/**
+ * @brief Shared state of a parallel sample sort.
+ */
+typedef struct sampleSortType
+{
+  int *A;                                 // Array to be sorted.
+  int *S;                                 // Scratch array of the buckets.
+  unsigned char *oracle;                  // Bucket of every element of A.
+  int n;                                  // Number of elements.
+  int numWorkers;                         // Number of workers, including the calling thread.
+  int numBuckets;                         // Number of buckets (a power of 2, at most 256).
+  int *tree;                              // Splitters as an implicit binary search tree (tree[1..numBuckets-1]).
+  int *counts;                            // counts[w*numBuckets+b]: elements of the chunk of worker w in bucket b.
+  int *bucketStart;                       // First position of every bucket in S (numBuckets+1 cells).
+  int *order;                             // Buckets by decreasing size, in the order they are sorted.
+  atomic_int nextBucket;                  // Next position of order to be sorted.
+  pthread_barrier_t barrier;              // Barrier between the phases.
+} sampleSortType;
+
+/**
+ * @brief Worker of a parallel sample sort.
+ */
+typedef struct sampleSortWorkerType
+{
+  sampleSortType *sort;                   // Shared state.
+  int id;                                 // Identifier of the worker (0 is the calling thread).
+} sampleSortWorkerType;
+
+/**
+ * @brief Buffered reader of a sorted run of the external sort.
+ */
+typedef struct
+{
+  FILE *file;                             // File containing the run.
+  int *buffer;                            // Buffer of externalBufferElements elements.
+  int size;                               // Number of valid elements in the buffer.
+  int position;                           // Position of the current element in the buffer.
+  bool exhausted;                         // Flag set when the run has no more elements.
+} runReaderType;
+
+/**
+ * @brief Statistics of an external sort.
+ */
+typedef struct
+{
+  long long elements;                     // Number of sorted elements.
+  int runs;                               // Number of sorted runs written by the first pass.
+  int passes;                             // Number of passes over the data (run formation plus merge passes).
+  long long bytesRead;                    // Bytes read from files.
+  long long bytesWritten;                 // Bytes written to files.
+  double seconds;                         // Wall-clock time.
+} externalStatsType;
+
 // ----- End AUXILIARY DATA STRUCTURES ----- //
 
 // ----- GLOBAL VARIABLES ----- //
@@ -48,21 +222,246 @@ typedef struct
 // Seed (important for reproducibility).
 time_t SEED = 20;
 // Minimum size of the array.
-const int minSize = 100;
+int minSize = 100;
 // Maximum size of the array.
-const int maxSize = 1000;
+int maxSize = 1000;
 // Number of experiments.
-const int numExperiments = 1500;
+int numExperiments = 1500;
 // Granularity of the experiment.
-const int granularity = 50;
+int granularity = 50;
 // Maximum random integer allowed when generating random numbers.
-const int maxRandInt = 1000000;
+int maxRandInt = 1000000;
 // Thereshold parameter for the base case of HybridSort.            IMPORTANT: this is the result of the first part of the experiment!
-const int threshold = 120;
+// Default value, replaced at startup by the one calibrated for this machine (see loadThreshold).
+int threshold = 120;
+// File caching the calibrated threshold of this machine.
+const char *thresholdProfileFile = "threshold.profile";
+// Calibrate the threshold at startup when there is no profile file?
+const bool calibrateAtStartup = true;
+// Calibrate the threshold even if the profile file exists?
+bool forceCalibration = false;
+// Largest size tried by the calibration.
+const int calibrationMaxSize = 512;
+// Step between two sizes tried by the calibration.
+const int calibrationStep = 8;
+// Number of elements sorted for each size and algorithm in a calibration round.
+const int calibrationElements = 16384;
+// Maximum number of calibration rounds.
+const int calibrationRounds = 7;
+// Time budget of the calibration in seconds (at least one round is always done).
+const double calibrationBudget = 1.0;
+// Stream of SEED of the calibration input (after the streams of the workers), so that the inputs of the
+// experiments do not depend on whether the threshold has been calibrated.
+const unsigned int calibrationStream = RUNNER_MAX_CORES;
+// Sorting algorithms compared by the experiment (see sortArray).
+const char *algorithms[] = { "insertionSort", "mergeSort", "hybridSort",
+  "mergeSortPingPong", "hybridSortPingPong", "hybridSortBranchless",
+  "hybridSortNetwork", "radixSort", "timSort"
+};
+// Number of sorting algorithms compared by the experiment.
+const int numAlgorithms = sizeof (algorithms) / sizeof (algorithms[0]);
+// Run the experiment on large arrays?
+bool runLargeExperiment = true;
+// Sorting algorithms compared by the experiment on large arrays.
+const char *largeAlgorithms[] = { "mergeSort", "hybridSort",
+  "hybridSortPingPong", "mergeSortBranchless", "hybridSortBranchless",
+  "bottomUpSort", "introSort", "radixSort"
+};
+// Number of sorting algorithms compared by the experiment on large arrays.
+const int numLargeAlgorithms =
+  sizeof (largeAlgorithms) / sizeof (largeAlgorithms[0]);
+// Minimum size of the array for the experiment on large arrays.
+const int largeMinSize = 10000;
+// Maximum size of the array for the experiment on large arrays (the size grows by a factor 10).
+const int largeMaxSize = 10000000;
+// Run the experiment on inputs with different distributions (adaptivity)?
+bool runAdaptiveExperiment = true;
+// Sorting algorithms compared by the adaptivity experiment.
+const char *adaptiveAlgorithms[] = { "mergeSort", "hybridSort", "timSort",
+  "introSort"
+};
+// Number of sorting algorithms compared by the adaptivity experiment.
+const int numAdaptiveAlgorithms =
+  sizeof (adaptiveAlgorithms) / sizeof (adaptiveAlgorithms[0]);
+// Size of the array for the adaptivity experiment.
+const int adaptiveExperimentSize = 1000000;
+// Names of the input distributions (same order as inputEnumType).
+const char *inputNames[] = { "random", "sorted", "reverse-sorted", "k-sorted",
+  "few-unique"
+};
+// Maximum distance of a key from its sorted position in K_SORTED inputs.
+const int kSortedDistance = 16;
+// Check the sorted, reverse-sorted and k-sorted inputs of 2 * maxRandInt elements at startup (off by default, see
+// --check-inputs)?
+bool checkInputs = false;
+// Number of distinct keys in FEW_UNIQUE inputs.
+const int fewUniqueKeys = 8;
+// Number of consecutive wins of a run after which TimSort's merge switches to galloping.
+int minGallop = 7;
+// Number of elements of a block sorted in L1 cache by BottomUpSort (16 KB of ints, plus as much scratch).
+const int l1BlockElements = 4096;
+// Number of runs merged together by every pass of BottomUpSort.
+const int bottomUpWays = 4;
+// Run the experiment on the cache behaviour of BottomUpSort (up to 2^24 elements; off by default, see --run-cache)?
+bool runCacheExperiment = false;
+// Maximum size of the array for the cache experiment (the size grows by a factor 4 from l1BlockElements).
+const int cacheExperimentMaxSize = 1 << 24;
+// Size at or below which IntroSort uses InsertionSort.
+int introSortThreshold = 24;
+// Size above which IntroSort chooses the pivot with Tukey's ninther instead of the median of 3.
+int nintherThreshold = 128;
+// Number of elements of a block of the block partitioning of IntroSort (offsets must fit an unsigned char).
+#define INTRO_BLOCK_SIZE 64
+// Run the experiment on the extra memory of IntroSort?
+bool runMemoryExperiment = true;
+// Size above which nthElement chooses the pivot with a Floyd-Rivest sample instead of the median of 3.
+int floydRivestThreshold = 600;
+// Run the experiment on partialSort, nthElement and the streaming top-k (10^7 elements; off by default, see
+// --run-selection)?
+bool runSelectionExperiment = false;
+// Size of the array of the selection experiment.
+const int selectionExperimentSize = 10000000;
+// Values of k of the selection experiment (the median is always added).
+const int selectionKs[] = { 1, 10, 1000, 100000 };
+// Number of elements pushed at a time into the streaming top-k by the selection experiment.
+const int topKChunkElements = 65536;
+// Size at or below which the record sorts use InsertionSort (records are moved with memcpy, keys through keyOf).
+int recordCutoff = 16;
+// Run the experiment on the record sorts (off by default, see --run-record)?
+bool runRecordExperiment = false;
+// Number of records of the experiment on the record sorts.
+const int recordExperimentSize = 1000000;
+// Widths in bytes of the records of the experiment on the record sorts.
+const size_t recordWidths[] = { 4, 8, 16, 64 };
+// Peak stack usage in bytes of the last call to IntroSort (of the current thread).
+_Thread_local size_t introPeakStack = 0;
+// Stack position at the beginning of the last call to IntroSort (of the current thread).
+_Thread_local char *introStackBase = NULL;
+// Number of bits of a digit of RadixSort.
+const int radixBits = 11;
+// Run the external sort experiment (it writes externalInputFile and externalOutputFile, then deletes them)?
+bool runExternalExperiment = false;
+// Binary file of random ints sorted by the external sort experiment.
+const char *externalInputFile = "external_input.bin";
+// Binary file written by the external sort experiment.
+const char *externalOutputFile = "external_output.bin";
+// Number of ints of the external sort experiment.
+const long long externalExperimentSize = 64000000;
+// Number of ints sorted in memory for each run of the external sort (i.e., the memory budget).
+const int externalChunkElements = 4000000;
+// Maximum number of runs merged together by one merge of the external sort.
+const int externalFanIn = 16;
+// Number of ints of the buffer of every reader and writer of the external sort.
+const int externalBufferElements = 262144;
+// Minimum size of a subarray (or of a merge output) handled as a separate task by ParallelHybridSort.
+int grainSize = 16384;
+// Number of threads used by ParallelHybridSort (0 means all the online cores).
+int numThreads = 0;
+// Maximum number of pending tasks in the deque of a worker.
+const int dequeCapacity = 1024;
+// Run the speedup experiment of ParallelHybridSort against HybridSort (10^7 elements for each number of threads;
+// off by default, see --run-parallel)?
+bool runParallelExperiment = false;
+// Size of the array of the speedup experiment.
+const int parallelExperimentSize = 10000000;
+// Number of repetitions of the speedup experiment for each number of threads.
+const int parallelExperimentRuns = 3;
+// Number of buckets of SampleSort for each thread (rounded up to a power of 2, at most 256 buckets).
+const int sampleSortBucketsPerThread = 8;
+// Number of samples drawn by SampleSort for each bucket.
+const int sampleSortOversampling = 32;
+// Elements of a cache line: the scatter of SampleSort buffers a line for each bucket.
+const int sampleSortLineElements = 16;
+// Size of the largest bucket of the last call to SampleSort divided by the size of an even bucket.
+double sampleSortImbalance = 0;
+// Run the scaling experiment of SampleSort (up to sampleSortMaxSize elements for each input and number of threads;
+// off by default, see --run-sample-sort)?
+bool runSampleSortExperiment = false;
+// Minimum size of the array of the scaling experiment of SampleSort.
+const int sampleSortMinSize = 1000000;
+// Maximum size of the array of the scaling experiment of SampleSort (the size grows by a factor 10; 10^9 needs 9 GB).
+const int sampleSortMaxSize = 100000000;
+// Distributions of the scaling experiment of SampleSort (FEW_UNIQUE leaves most buckets empty).
+const inputEnumType sampleSortInputs[] = { RANDOM, SORTED, FEW_UNIQUE };
+// Run the experiment comparing the time per element of InsertionSort and NetworkSort as base cases?
+bool runBaseCaseExperiment = true;
+// Number of arrays sorted for each size by the base case experiment.
+const int baseCaseExperimentRuns = 2000;
+// Comparators of the optimal sorting network for 8 elements (19 comparators, depth 6).
+const int network8[19][2] = { {0, 2}, {1, 3}, {4, 6}, {5, 7},
+{0, 4}, {1, 5}, {2, 6}, {3, 7},
+{0, 1}, {2, 3}, {4, 5}, {6, 7},
+{2, 4}, {3, 5},
+{1, 4}, {3, 6},
+{1, 2}, {3, 4}, {5, 6}
+};
+// Identifier of the worker running on the current thread (0 is the thread calling the sort).
+_Thread_local int workerId = 0;
+// Generator of the current thread for choosing the victim of a steal (stream workerId of SEED).
+_Thread_local prng_t stealGenerator = PRNG_INITIALIZER;
+// Generator of the inputs of the current thread (stream 0 of SEED for the main thread).
+_Thread_local prng_t randomGenerator = PRNG_INITIALIZER;
+// Number of untimed warmup runs for each size before the numExperiments timed ones.
+int numWarmupRuns = 10;
+// Core the experiment is pinned to (a negative value leaves it unpinned).
+int pinCore = -1;
+// Machine-readable output of the statistics of the experiment (in addition to the table).
+benchmarkFormat_t benchmarkFormat = BENCHMARK_NONE;
+// File of the machine-readable output.
+char *benchmarkFile = "results.csv";
+// Measure the hardware performance counters of sortArray (extra columns of the table)?
+bool measureCounters = false;
+// Hardware performance counters of the current thread (opened by main and by the workers of the runner if measureCounters).
+_Thread_local perfCounters_t perfCounters;
+// Number of threads running the (size, repetition) jobs of the main experiment (1: serial, 0: one for each core).
+int experimentThreads = 1;
+// Pin the threads of the main experiment only to the isolated cores (isolcpus=), so that the timings stay clean?
+bool isolatedCoresOnly = false;
 // Output type.
-const outputEnumType outputType = ONCONSOLE;
+outputEnumType outputType = ONCONSOLE;
 // Output pointer (for printing).
 FILE *outputPointer;
+// Names of the output types, in the order of outputEnumType.
+const char *const outputNames[] = { "console", "file", NULL };
+// Runtime parameters: the globals above that can be set from the command line or a config file (see options.h).
+option_t options[] = {
+  {"seed", OPTION_TIME, &SEED, "Seed of the inputs", NULL, false},
+  {"min-size", OPTION_INT, &minSize, "Minimum size of the array", NULL, false},
+  {"max-size", OPTION_INT, &maxSize, "Maximum size of the array", NULL, false},
+  {"experiments", OPTION_INT, &numExperiments, "Number of timed runs for each size", NULL, false},
+  {"granularity", OPTION_INT, &granularity, "Step between two sizes", NULL, false},
+  {"max-rand-int", OPTION_INT, &maxRandInt, "Maximum random integer", NULL, false},
+  {"check-inputs", OPTION_BOOL, &checkInputs, "Check the sorted inputs of 2 * max-rand-int elements at startup", NULL, false},
+  {"warmups", OPTION_INT, &numWarmupRuns, "Number of untimed runs for each size", NULL, false},
+  {"threshold", OPTION_INT, &threshold, "Threshold of HybridSort (skips the profile and the calibration)", NULL, false},
+  {"force-calibration", OPTION_BOOL, &forceCalibration, "Calibrate the threshold even if the profile exists", NULL, false},
+  {"intro-sort-threshold", OPTION_INT, &introSortThreshold, "Size at or below which IntroSort uses InsertionSort", NULL, false},
+  {"ninther-threshold", OPTION_INT, &nintherThreshold, "Size above which IntroSort uses the ninther pivot", NULL, false},
+  {"floyd-rivest-threshold", OPTION_INT, &floydRivestThreshold, "Size above which nthElement uses Floyd-Rivest pivots", NULL, false},
+  {"record-cutoff", OPTION_INT, &recordCutoff, "Size at or below which the record sorts use InsertionSort", NULL, false},
+  {"min-gallop", OPTION_INT, &minGallop, "Initial galloping threshold of TimSort", NULL, false},
+  {"grain-size", OPTION_INT, &grainSize, "Minimum size of a task of the parallel sorts", NULL, false},
+  {"threads", OPTION_INT, &numThreads, "Threads of the parallel sorts (0: all the cores)", NULL, false},
+  {"experiment-threads", OPTION_INT, &experimentThreads, "Threads running the jobs of the main experiment (1: serial, 0: all the cores)", NULL, false},
+  {"isolated-cores", OPTION_BOOL, &isolatedCoresOnly, "Run the jobs of the main experiment only on the isolated cores", NULL, false},
+  {"pin-core", OPTION_INT, &pinCore, "Core the experiment is pinned to (-1: unpinned)", NULL, false},
+  {"counters", OPTION_BOOL, &measureCounters, "Measure the hardware performance counters", NULL, false},
+  {"benchmark-format", OPTION_ENUM, &benchmarkFormat, "Machine-readable output of the statistics", benchmarkFormatNames, false},
+  {"benchmark-file", OPTION_STRING, &benchmarkFile, "File of the machine-readable output", NULL, false},
+  {"output", OPTION_ENUM, &outputType, "Output of the tables (file: results.txt)", outputNames, false},
+  {"run-large", OPTION_BOOL, &runLargeExperiment, "Run the experiment on large arrays", NULL, false},
+  {"run-selection", OPTION_BOOL, &runSelectionExperiment, "Run the selection experiment", NULL, false},
+  {"run-record", OPTION_BOOL, &runRecordExperiment, "Run the record sort experiment", NULL, false},
+  {"run-memory", OPTION_BOOL, &runMemoryExperiment, "Run the extra memory experiment", NULL, false},
+  {"run-cache", OPTION_BOOL, &runCacheExperiment, "Run the cache experiment", NULL, false},
+  {"run-adaptive", OPTION_BOOL, &runAdaptiveExperiment, "Run the input distribution experiment", NULL, false},
+  {"run-base-case", OPTION_BOOL, &runBaseCaseExperiment, "Run the base case experiment", NULL, false},
+  {"run-parallel", OPTION_BOOL, &runParallelExperiment, "Run the speedup experiment of ParallelHybridSort", NULL, false},
+  {"run-sample-sort", OPTION_BOOL, &runSampleSortExperiment, "Run the scaling experiment of SampleSort", NULL, false},
+  {"run-external", OPTION_BOOL, &runExternalExperiment, "Run the external sort experiment", NULL, false}
+};
+// Number of runtime parameters.
+const int numOptions = sizeof (options) / sizeof (options[0]);
 
 // ----- End GLOBAL VARIABLES ----- //
 
@@ -77,9 +476,73 @@ void
 generateRandomArray (int *A, const int n)
 {
   // For each i in 0..n-1, generate a random number in the interval [1,maxRandInt].
+  prngFill (&randomGenerator, A, n, maxRandInt, 1);
+}
+
+/**
+ * @brief Generate a non-decreasing collection of random numbers in the interval [1,maxRandInt] into an array A of size n.
+ * @param A Array of random numbers.
+ * @param n Size of the array.
+ */
+void
+generateSortedArray (int *A, const int n)
+{
+  // Random increments whose mean maxRandInt/n spreads the keys over [1,maxRandInt]. They are accumulated as
+  // fractions, so that they do not round down to 0 when n > maxRandInt.
+  const double step = 2.0 * maxRandInt / (n > 0 ? n : 1) / 65536;
+  double key = 1;
   int i;
   for (i = 0; i < n; i++)
-    A[i] = rand () % maxRandInt + 1;
+    {
+      key += step * prngBounded (&randomGenerator, 65536);
+      A[i] = key < maxRandInt ? (int) key : maxRandInt;
+    }
+}
+
+/**
+ * @brief Generate a collection of numbers with the given distribution into an array A of size n.
+ * @param A Array of numbers.
+ * @param n Size of the array.
+ * @param input Distribution of the numbers.
+ */
+void
+generateArray (int *A, const int n, const inputEnumType input)
+{
+  int i, j, k, block, tmp;
+  switch (input)
+    {
+    case RANDOM:
+      generateRandomArray (A, n);
+      break;
+    case SORTED:
+      generateSortedArray (A, n);
+      break;
+    case REVERSE_SORTED:
+      generateSortedArray (A, n);
+      for (i = 0, j = n - 1; i < j; i++, j--)
+	{
+	  tmp = A[i];
+	  A[i] = A[j];
+	  A[j] = tmp;
+	}
+      break;
+    case K_SORTED:
+      // Shuffle disjoint blocks of kSortedDistance+1 keys, so no key moves farther than kSortedDistance.
+      generateSortedArray (A, n);
+      for (block = 0; block < n; block += kSortedDistance + 1)
+	for (i = (block + kSortedDistance < n ? block + kSortedDistance : n - 1); i > block; i--)
+	  {
+	    k = block + prngBounded (&randomGenerator, i - block + 1);
+	    tmp = A[i];
+	    A[i] = A[k];
+	    A[k] = tmp;
+	  }
+      break;
+    case FEW_UNIQUE:
+      for (i = 0; i < n; i++)
+	A[i] = (prngBounded (&randomGenerator, fewUniqueKeys) + 1) * (maxRandInt / fewUniqueKeys);
+      break;
+    }
 }
 
 /**
@@ -97,12 +560,37 @@ displayArray (const int *A, const int n)
   printf ("\n");
 }
 
+/**
+ * @brief Wall-clock time in seconds (see benchmarkNowNs).
+ * @return Seconds elapsed from an arbitrary fixed point in the past.
+ */
+double
+wallClockTime ()
+{
+  return benchmarkNowNs () * 1e-9;
+}
+
+/**
+ * @brief CPU time stamp counter, for measuring cycles.
+ * @return Current value of the time stamp counter (0 where it is not available).
+ */
+unsigned long long
+cycleCounter ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc ();
+#else
+  return 0;
+#endif
+}
+
 // ----- End AUXILIARY FUNCTIONS ----- //
 
 // ----- ANTAGONISTIC FUNCTIONS ----- //
 
 /**
- * @brief Unit test: check if the input array A of size n is sorted.
+ * @brief Unit test: check if the input array A of size n is sorted. Each A[i..i+7] is compared with A[i+1..i+8]
+ *        by AVX2 (when available), and large arrays are split among numThreads threads (see verify.h).
  * @param A Array to be checked if sorted.
  * @param n Size of the array.
  * @return true if it is sorted; otherwise, false
@@ -110,18 +598,294 @@ displayArray (const int *A, const int n)
 bool
 isSorted (const int *A, const int n)
 {
-  // For each i in 0..n-2, if the current element is greater than the next one,
-  // then it is unsorted.
+  // Fewer than 2 elements are always sorted.
+  if (n < 2)
+    return true;
+  return verifyIsSorted (A, n, numThreads);
+}
+
+/**
+ * @brief Unit test: check if the sorted array A of size n holds exactly the elements of the input (e.g., no element
+ *        has been lost or duplicated), comparing the order-independent hashes of their multisets.
+ * @param A Array to be checked.
+ * @param n Size of the array.
+ * @param inputHash Hash of the input, computed by verifyMultisetHash before sorting.
+ * @return true if the multisets have the same hash; otherwise, false
+ */
+bool
+isPermutation (const int *A, const int n, const uint64_t inputHash)
+{
+  return n < 1 || verifyMultisetHash (A, n, numThreads) == inputHash;
+}
+
+/**
+ * @brief Unit test: check if the prefix A[0..k-1] is sorted and no element of A[k..n-1] is smaller than A[k-1]
+ *        (the output of partialSort).
+ * @param A Array to be checked.
+ * @param n Size of the array.
+ * @param k Size of the prefix.
+ * @return True if it is a sorted top-k prefix; otherwise, false.
+ */
+bool
+isPartiallySorted (const int *A, const int n, const int k)
+{
+  int i;
+  if (!isSorted (A, k))
+    return false;
+  for (i = k; k > 0 && i < n; i++)
+    if (A[i] < A[k - 1])
+      return false;
+  return true;
+}
+
+/**
+ * @brief Unit test: check if A[k] separates A, with A[0..k-1] <= A[k] <= A[k+1..n-1] (the output of nthElement).
+ * @param A Array to be checked.
+ * @param n Size of the array.
+ * @param k Index of the selected element.
+ * @return True if A[k] separates A; otherwise, false.
+ */
+bool
+isNthElement (const int *A, const int n, const int k)
+{
   int i;
-  for (i = 0; i < n - 1; i++)
-    if (A[i] > A[i + 1])
+  for (i = 0; i < n; i++)
+    if ((i < k && A[i] > A[k]) || (i > k && A[i] < A[k]))
       return false;
-  // Otherwise it is.
   return true;
 }
 
+/**
+ * @brief Unit test: check if the sorted, reverse-sorted and k-sorted inputs of size n are ordered as expected and
+ *        do not saturate at maxRandInt (e.g., when n > maxRandInt), i.e., their second halves are not constant. The inputs are drawn from a copy of the generator, so that the
+ *        other inputs do not depend on the check.
+ * @param n Size of the inputs.
+ * @return True if all of them are correct; otherwise, false.
+ */
+bool
+checkSortedInputs (const int n)
+{
+  const prng_t saved = randomGenerator;
+  int *A = malloc (n * sizeof (int));
+  bool correct = A != NULL && n > 2 * kSortedDistance + 2;
+  if (correct)
+    {
+      generateArray (A, n, SORTED);
+      correct = isSorted (A, n) && A[0] < A[n / 2] && A[n / 2] < A[n - 1];
+      generateArray (A, n, REVERSE_SORTED);
+      correct = correct && A[0] > A[n / 2] && A[n / 2] > A[n - 1];
+      // The first and the last blocks of a k-sorted input stay apart.
+      generateArray (A, n, K_SORTED);
+      correct = correct && A[kSortedDistance] < A[n - 1 - kSortedDistance];
+    }
+  randomGenerator = saved;
+  free (A);
+  return correct;
+}
+
 // ----- End ANTAGONISTIC FUNCTIONS ----- //
 
+// ----- THREAD POOL ----- //
+
+/**
+ * @brief Initialize a task.
+ * @param task Task to be initialized.
+ * @param run Function executing the task.
+ * @param pool Thread pool running the task.
+ * @param D Destination array.
+ * @param S Source (scratch) array.
+ * @param p Left-end index of the input.
+ * @param q Mid index of the input (merge only).
+ * @param r Right-end index of the input.
+ * @param low First output index (merge only).
+ * @param high One past the last output index (merge only).
+ */
+void
+initTask (taskType *task, void (*run) (taskType *), threadPoolType *pool,
+	  int *D, int *S, const int p, const int q, const int r,
+	  const int low, const int high)
+{
+  task->run = run;
+  atomic_init (&task->done, false);
+  task->pool = pool;
+  task->D = D;
+  task->S = S;
+  task->p = p;
+  task->q = q;
+  task->r = r;
+  task->low = low;
+  task->high = high;
+}
+
+/**
+ * @brief Execute a task and mark it as done.
+ * @param task Task to be executed.
+ */
+void
+threadPoolRun (taskType *task)
+{
+  task->run (task);
+  atomic_store (&task->done, true);
+}
+
+/**
+ * @brief Push a task on the deque of the calling worker. If the deque is full, the task is executed immediately.
+ * @param pool Thread pool.
+ * @param task Task to be spawned.
+ */
+void
+threadPoolSpawn (threadPoolType *pool, taskType *task)
+{
+  dequeType *deque = &pool->deques[workerId];
+  pthread_mutex_lock (&deque->lock);
+  if (deque->tail < dequeCapacity)
+    {
+      deque->tasks[deque->tail++] = task;
+      pthread_mutex_unlock (&deque->lock);
+    }
+  else
+    {
+      pthread_mutex_unlock (&deque->lock);
+      threadPoolRun (task);
+    }
+}
+
+/**
+ * @brief Take a task from the given end of a deque.
+ * @param deque Deque.
+ * @param fromTail true for the owner of the deque (newest task); false for a thief (oldest task).
+ * @return The task, if the deque is not empty; otherwise, NULL.
+ */
+taskType *
+dequeTake (dequeType *deque, const bool fromTail)
+{
+  taskType *task = NULL;
+  pthread_mutex_lock (&deque->lock);
+  if (deque->head < deque->tail)
+    task = fromTail ? deque->tasks[--deque->tail] : deque->tasks[deque->head++];
+  if (deque->head == deque->tail)
+    deque->head = deque->tail = 0;
+  pthread_mutex_unlock (&deque->lock);
+  return task;
+}
+
+/**
+ * @brief Find a task for the calling worker: first its own newest task, then the oldest task of another worker.
+ * @param pool Thread pool.
+ * @return The task, if any; otherwise, NULL.
+ */
+taskType *
+threadPoolFindTask (threadPoolType *pool)
+{
+  int i, victim, start;
+  taskType *task = dequeTake (&pool->deques[workerId], true);
+  if (task != NULL || pool->numWorkers == 1)
+    return task;
+  start = prngBounded (&stealGenerator, pool->numWorkers);
+  for (i = 0; i < pool->numWorkers && task == NULL; i++)
+    {
+      victim = (start + i) % pool->numWorkers;
+      if (victim != workerId)
+	task = dequeTake (&pool->deques[victim], false);
+    }
+  return task;
+}
+
+/**
+ * @brief Wait until a spawned task is done, executing other tasks in the meantime.
+ * @param pool Thread pool.
+ * @param task Task to be waited for.
+ */
+void
+threadPoolWait (threadPoolType *pool, taskType *task)
+{
+  taskType *other;
+  while (!atomic_load (&task->done))
+    {
+      other = threadPoolFindTask (pool);
+      if (other != NULL)
+	threadPoolRun (other);
+      else
+	sched_yield ();
+    }
+}
+
+/**
+ * @brief Main loop of the workers 1..numWorkers-1: execute or steal tasks until shutdown.
+ * @param argument Deque of the worker.
+ * @return NULL.
+ */
+void *
+threadPoolWorker (void *argument)
+{
+  dequeType *deque = argument;
+  threadPoolType *pool = deque->pool;
+  taskType *task;
+  workerId = deque - pool->deques;
+  prngSeed (&stealGenerator, SEED, workerId);
+  while (!atomic_load (&pool->shutdown))
+    {
+      task = threadPoolFindTask (pool);
+      if (task != NULL)
+	threadPoolRun (task);
+      else
+	sched_yield ();
+    }
+  return NULL;
+}
+
+/**
+ * @brief Create a work-stealing thread pool. The calling thread becomes worker 0.
+ * @param numWorkers Number of workers, including the calling thread.
+ * @return Newly created thread pool.
+ */
+threadPoolType *
+createThreadPool (const int numWorkers)
+{
+  int i;
+  threadPoolType *pool = malloc (sizeof (threadPoolType));
+  pool->numWorkers = numWorkers;
+  pool->threads = malloc (numWorkers * sizeof (pthread_t));
+  pool->deques = malloc (numWorkers * sizeof (dequeType));
+  atomic_init (&pool->shutdown, false);
+  for (i = 0; i < numWorkers; i++)
+    {
+      pthread_mutex_init (&pool->deques[i].lock, NULL);
+      pool->deques[i].tasks = malloc (dequeCapacity * sizeof (taskType *));
+      pool->deques[i].head = pool->deques[i].tail = 0;
+      pool->deques[i].pool = pool;
+    }
+  workerId = 0;
+  prngSeed (&stealGenerator, SEED, 0);
+  for (i = 1; i < numWorkers; i++)
+    pthread_create (&pool->threads[i], NULL, threadPoolWorker,
+		    &pool->deques[i]);
+  return pool;
+}
+
+/**
+ * @brief Stop the workers and free the thread pool.
+ * @param pool Thread pool to be freed.
+ */
+void
+freeThreadPool (threadPoolType *pool)
+{
+  int i;
+  atomic_store (&pool->shutdown, true);
+  for (i = 1; i < pool->numWorkers; i++)
+    pthread_join (pool->threads[i], NULL);
+  for (i = 0; i < pool->numWorkers; i++)
+    {
+      pthread_mutex_destroy (&pool->deques[i].lock);
+      free (pool->deques[i].tasks);
+    }
+  free (pool->deques);
+  free (pool->threads);
+  free (pool);
+}
+
+// ----- End THREAD POOL ----- //
+
 // ----- CORE FUNCTIONS ----- //
 
 /**
@@ -257,93 +1021,3188 @@ hybridSort (int *A, const int p, const int r)
 }
 
 /**
- * @brief Polymorphic function that calls different sorting algorithms.
- * @param randomArray Array of random numbers to be sorted.
- * @param dim Dimension of the input array.
- * @param algo Sorting algorithm to be called. The possible values are: insertionSort,
- *             mergeSort and hybridSort.
- * @return Pair containing the total time needed to sort and the isSorted flag.
+ * @brief Merge algorithm without temporary allocations: merges the sorted runs S[p..q] and S[q+1..r] into D[p..r].
+ * @param S Source array containing the two sorted runs.
+ * @param D Destination array.
+ * @param p Left-end index of the first run.
+ * @param q Right-end index of the first run.
+ * @param r Right-end index of the second run.
+ * @property It takes O(n), where n=r-p+1 is the size of the input array.
  */
-pairType
-sortArray (const int *randomArray, const int dim, const char *algo)
+void
+mergePingPong (const int *S, int *D, const int p, const int q, const int r)
 {
-  // Initiliazation of a pairType with values time = 0 and isSorted = true.
-  pairType pair = { 0, true };
-  int i;
-  // Start and end time.
-  clock_t startTime, endTime = 0;
-
-  // Allocate memory for dim integers.
-  int *sliceRandomArray = malloc (dim * sizeof (int));
-  // Put every i-th element of randomArray into sliceRandomArray for each i in [0, ..., dim-1].
-  for (i = 0; i < dim; i++)
-    sliceRandomArray[i] = randomArray[i];
-
-  // Start the clock.
-  startTime = clock ();
-  // Use InsertionSort.
-  if (strcmp (algo, "insertionSort") == 0)
-    insertionSort (sliceRandomArray, 0, dim - 1);
-  // Use MergeSort.
-  else if (strcmp (algo, "mergeSort") == 0)
-    mergeSort (sliceRandomArray, 0, dim - 1);
-  // Use HybridSort.
-  else if (strcmp (algo, "hybridSort") == 0)
-    hybridSort (sliceRandomArray, 0, dim - 1);
-  // Error
-  else
+  int i = p;
+  int j = q + 1;
+  int k;
+  for (k = p; k <= r; k++)
     {
-      fprintf (stderr,
-	       "ERROR: There is no such sorting algorithm called %s\n", algo);
-      exit (1);
+      if (j > r || (i <= q && S[i] <= S[j]))
+	D[k] = S[i++];
+      else
+	D[k] = S[j++];
     }
-  // Stop the clock.
-  endTime = clock ();
-
-  // Total time needed to sort.
-  pair.time = endTime - startTime;
-  // Have we sorted the instance? If not, then the flag is set to false; otherwise, it remains true.
-  if (!isSorted (sliceRandomArray, dim))
-    pair.isSorted = false;
-
-  // Free sliceRandomArray.
-  free (sliceRandomArray);
-
-  return pair;
 }
 
-// ----- End CORE FUNCTIONS ----- //
+/**
+ * @brief Branchless merge kernel: merges the sorted runs S[p..q] and S[q+1..r] into D[p..r]. The choice of the next
+ *        element is a conditional move and the advance of the indices is arithmetic on the comparison result, so the
+ *        only branch is the (predictable) loop test; the tail of the non-exhausted run is copied in bulk.
+ * @param S Source array containing the two sorted runs.
+ * @param D Destination array.
+ * @param p Left-end index of the first run.
+ * @param q Right-end index of the first run.
+ * @param r Right-end index of the second run.
+ * @property It takes O(n), where n=r-p+1 is the size of the input array.
+ */
+void
+mergeBranchless (const int *S, int *D, const int p, const int q, const int r)
+{
+  const int *L = S + p;
+  const int *R = S + q + 1;
+  const int *endL = S + q + 1;
+  const int *endR = S + r + 1;
+  int *out = D + p;
+  int l, x, takeRight;
+  while (L < endL && R < endR)
+    {
+      l = *L;
+      x = *R;
+      takeRight = x < l;
+      *out++ = takeRight ? x : l;
+      R += takeRight;
+      L += 1 - takeRight;
+    }
+  memcpy (out, L, (endL - L) * sizeof (int));
+  memcpy (out + (endL - L), R, (endR - R) * sizeof (int));
+}
 
-// ----- MAIN FUNCTION ----- //
+/**
+ * @brief Ping-pong sort: sorts D[p..r] using S[p..r] as scratch, swapping the roles of the two arrays at every level.
+ * @param D Destination array (it holds the sorted output on return).
+ * @param S Scratch array; on entry S[p..r] must hold the same elements as D[p..r].
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @param cutoff Size at or below which insertionSort is used (1 means plain MergeSort).
+ * @param branchless true for the mergeBranchless kernel; false for mergePingPong.
+ * @property It takes O(n*logn) and allocates no memory, where n=r-p+1 is the size of the input array.
+ */
+void
+pingPongSort (int *D, int *S, const int p, const int r, const int cutoff,
+	      const bool branchless)
+{
+  int q;
+  if (r - p + 1 <= cutoff)
+    {
+      insertionSort (D, p, r);
+      return;
+    }
+  q = (p + r) / 2;
+  pingPongSort (S, D, p, q, cutoff, branchless);	//Ramo sinistro (ordinato in S)
+  pingPongSort (S, D, q + 1, r, cutoff, branchless);	//Ramo destro (ordinato in S)
+  if (branchless)
+    mergeBranchless (S, D, p, q, r);	//Combina in D
+  else
+    mergePingPong (S, D, p, q, r);	//Combina in D
+}
 
 /**
- * @brief Main function.
- * @return Exit code 0.
+ * @brief Entry point of the ping-pong sorts: copies A into the scratch buffer once, then sorts.
+ * @param A Array to be sorted.
+ * @param buffer Scratch buffer of at least r-p+1 cells, or NULL to allocate one internally.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @param cutoff Size at or below which insertionSort is used.
+ * @param branchless true for the mergeBranchless kernel; false for mergePingPong.
  */
-int
-main ()
-{
-  // Initialize the random seed only once.
-  srand (SEED);
-  int exper, dim;
-  // Accumulated times.
-  clock_t timeIS = 0;		// InsertionSort
-  clock_t timeMS = 0;		// MergeSort
-  clock_t timeHS = 0;		// HybridSort
-  // Flags saying either that the output of the execution is correct or not.
-  bool isSortedIS = true;	// InsertionSort
-  bool isSortedMS = true;	// MergeSort
-  bool isSortedHS = true;	// HybridSort
-  // Pairs for each of the sorting algorithms.
-  pairType pairIS;		// InsertionSort
-  pairType pairMS;		// MergeSort
-  pairType pairHS;		// HybridSort
-
-  // Allocate an array of maxSize*sizeof(int) cells on the heap.
-  // We use this array as a container.
-  int *randomArray = malloc (maxSize * sizeof (int));
+void
+pingPongSortBuffered (int *A, int *buffer, const int p, const int r,
+		      const int cutoff, const bool branchless)
+{
+  int n = r - p + 1;
+  int *S = buffer;
+  if (n <= 1)
+    return;
+  if (S == NULL)
+    S = malloc (n * sizeof (int));
+  memcpy (S, A + p, n * sizeof (int));
+  pingPongSort (A + p, S, 0, n - 1, cutoff, branchless);
+  if (buffer == NULL)
+    free (S);
+}
 
-  // What is the outputPointer?
+/**
+ * @brief MergeSort algorithm with a single reusable scratch buffer.
+ * @param A Array of random numbers to be sorted.
+ * @param buffer Scratch buffer of at least r-p+1 cells, or NULL to allocate one internally.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+mergeSortPingPong (int *A, int *buffer, const int p, const int r)
+{
+  pingPongSortBuffered (A, buffer, p, r, 1, false);
+}
+
+/**
+ * @brief HybridSort algorithm with a single reusable scratch buffer.
+ * @param A Array of random numbers to be sorted.
+ * @param buffer Scratch buffer of at least r-p+1 cells, or NULL to allocate one internally.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+hybridSortPingPong (int *A, int *buffer, const int p, const int r)
+{
+  pingPongSortBuffered (A, buffer, p, r, threshold, false);
+}
+
+/**
+ * @brief MergeSort algorithm with a single reusable scratch buffer and the branchless merge kernel.
+ * @param A Array of random numbers to be sorted.
+ * @param buffer Scratch buffer of at least r-p+1 cells, or NULL to allocate one internally.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+mergeSortBranchless (int *A, int *buffer, const int p, const int r)
+{
+  pingPongSortBuffered (A, buffer, p, r, 1, true);
+}
+
+/**
+ * @brief HybridSort algorithm with a single reusable scratch buffer and the branchless merge kernel.
+ * @param A Array of random numbers to be sorted.
+ * @param buffer Scratch buffer of at least r-p+1 cells, or NULL to allocate one internally.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+hybridSortBranchless (int *A, int *buffer, const int p, const int r)
+{
+  pingPongSortBuffered (A, buffer, p, r, threshold, true);
+}
+
+/**
+ * @brief Merge two sorted arrays, copying the tail of the non-exhausted one in bulk.
+ * @param L First sorted array.
+ * @param n1 Size of L.
+ * @param R Second sorted array.
+ * @param n2 Size of R.
+ * @param D Destination array of n1+n2 cells.
+ * @property It takes O(n), where n=n1+n2.
+ */
+void
+mergeRuns (const int *L, const int n1, const int *R, const int n2, int *D)
+{
+  int i = 0;
+  int j = 0;
+  int k = 0;
+  while (i < n1 && j < n2)
+    {
+      if (L[i] <= R[j])
+	D[k++] = L[i++];
+      else
+	D[k++] = R[j++];
+    }
+  memcpy (D + k, L + i, (n1 - i) * sizeof (int));
+  memcpy (D + k + n1 - i, R + j, (n2 - j) * sizeof (int));
+}
+
+/**
+ * @brief Co-ranking (merge path): how many of the first k merged elements come from the first array.
+ * @param k Rank in the merged output.
+ * @param L First sorted array.
+ * @param n1 Size of L.
+ * @param R Second sorted array.
+ * @param n2 Size of R.
+ * @return The index i such that the first k merged elements are L[0..i-1] and R[0..k-i-1].
+ * @property It takes O(log(min(k, n1+n2-k))).
+ */
+int
+coRank (const int k, const int *L, const int n1, const int *R, const int n2)
+{
+  int low = k > n2 ? k - n2 : 0;
+  int high = k < n1 ? k : n1;
+  int i, j;
+  while (true)
+    {
+      i = (low + high) / 2;
+      j = k - i;
+      // Too many elements taken from L (ties go to L, as in merge).
+      if (i > 0 && j < n2 && L[i - 1] > R[j])
+	high = i - 1;
+      // Too few elements taken from L.
+      else if (j > 0 && i < n1 && R[j - 1] >= L[i])
+	low = i + 1;
+      else
+	return i;
+    }
+}
+
+/**
+ * @brief Task merging S[p..q] and S[q+1..r] into D[low..high-1]: large outputs are split in two halves by co-ranking.
+ * @param task Merge task.
+ */
+void
+parallelMergeTask (taskType *task)
+{
+  taskType left, right;
+  int n1 = task->q - task->p + 1;
+  int n2 = task->r - task->q;
+  const int *L = task->S + task->p;
+  const int *R = task->S + task->q + 1;
+  int mid, i0, i1;
+  if (task->high - task->low <= grainSize)
+    {
+      i0 = coRank (task->low - task->p, L, n1, R, n2);
+      i1 = coRank (task->high - task->p, L, n1, R, n2);
+      mergeRuns (L + i0, i1 - i0, R + task->low - task->p - i0,
+		 (task->high - task->p - i1) - (task->low - task->p - i0),
+		 task->D + task->low);
+      return;
+    }
+  mid = task->low + (task->high - task->low) / 2;
+  initTask (&left, parallelMergeTask, task->pool, task->D, task->S, task->p,
+	    task->q, task->r, task->low, mid);
+  initTask (&right, parallelMergeTask, task->pool, task->D, task->S, task->p,
+	    task->q, task->r, mid, task->high);
+  threadPoolSpawn (task->pool, &left);
+  parallelMergeTask (&right);
+  threadPoolWait (task->pool, &left);
+}
+
+/**
+ * @brief Task sorting D[p..r] with S[p..r] as scratch (same contract as pingPongSort): the left subtree is spawned,
+ *        the right one runs on the current worker, then the halves are merged in parallel.
+ * @param task Sort task.
+ */
+void
+parallelSortTask (taskType *task)
+{
+  taskType left, right, merger;
+  int q;
+  if (task->r - task->p + 1 <= grainSize)
+    {
+      pingPongSort (task->D, task->S, task->p, task->r, threshold, true);
+      return;
+    }
+  q = (task->p + task->r) / 2;
+  initTask (&left, parallelSortTask, task->pool, task->S, task->D, task->p,
+	    0, q, 0, 0);
+  initTask (&right, parallelSortTask, task->pool, task->S, task->D, q + 1,
+	    0, task->r, 0, 0);
+  threadPoolSpawn (task->pool, &left);	//Ramo sinistro
+  parallelSortTask (&right);	//Ramo destro
+  threadPoolWait (task->pool, &left);
+  initTask (&merger, parallelMergeTask, task->pool, task->D, task->S,
+	    task->p, q, task->r, task->p, task->r + 1);
+  parallelMergeTask (&merger);	//Combina
+}
+
+/**
+ * @brief Multithreaded HybridSort algorithm on a work-stealing thread pool.
+ * @param A Array of random numbers to be sorted.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @param threads Number of threads (0 means all the online cores).
+ * @property It takes O(n*logn) work and O(log^2 n) span above grainSize, where n=r-p+1 is the size of the input array.
+ */
+void
+parallelHybridSort (int *A, const int p, const int r, const int threads)
+{
+  int n = r - p + 1;
+  int workers = threads > 0 ? threads : (int) sysconf (_SC_NPROCESSORS_ONLN);
+  int *S;
+  threadPoolType *pool;
+  taskType root;
+  if (n <= grainSize)
+    {
+      hybridSortPingPong (A, NULL, p, r);
+      return;
+    }
+  S = malloc (n * sizeof (int));
+  memcpy (S, A + p, n * sizeof (int));
+  pool = createThreadPool (workers);
+  initTask (&root, parallelSortTask, pool, A + p, S, 0, 0, n - 1, 0, 0);
+  parallelSortTask (&root);
+  freeThreadPool (pool);
+  free (S);
+}
+
+/**
+ * @brief Bucket of a key: descent of the implicit binary search tree of the splitters (no branches on the key).
+ * @param tree Splitters as an implicit binary search tree.
+ * @param numBuckets Number of buckets (a power of 2).
+ * @param x Key.
+ * @return Bucket of the key: the keys of bucket b are greater than those of bucket b-1.
+ */
+static inline int
+sampleSortBucket (const int *tree, const int numBuckets, const int x)
+{
+  int j = 1;
+  while (j < numBuckets)
+    j = 2 * j + (x > tree[j]);
+  return j - numBuckets;
+}
+
+/**
+ * @brief Store the sorted splitters s[lo..hi] in the implicit binary search tree rooted at node j.
+ * @param tree Implicit binary search tree.
+ * @param j Root node.
+ * @param s Sorted splitters.
+ * @param lo Left-end index of the splitters.
+ * @param hi Right-end index of the splitters.
+ */
+void
+sampleSortBuildTree (int *tree, const int j, const int *s, const int lo, const int hi)
+{
+  int mid;
+  if (lo > hi)
+    return;
+  mid = (lo + hi) / 2;
+  tree[j] = s[mid];
+  sampleSortBuildTree (tree, 2 * j, s, lo, mid - 1);
+  sampleSortBuildTree (tree, 2 * j + 1, s, mid + 1, hi);
+}
+
+/**
+ * @brief Write the buffered elements of a bucket of SampleSort to S: a whole cache line with non-temporal stores, so
+ *        that the scatter does not evict the chunk being read from the cache; a part of a line with regular stores.
+ * @param D Destination in S (aligned to a cache line if size is sampleSortLineElements).
+ * @param line Buffered elements.
+ * @param size Number of buffered elements.
+ */
+static inline void
+sampleSortFlush (int *D, const int *line, const int size)
+{
+#if defined(__SSE2__)
+  int j;
+  if (size == sampleSortLineElements)
+    {
+      for (j = 0; j < sampleSortLineElements; j += 4)
+	_mm_stream_si128 ((__m128i *) (D + j), _mm_loadu_si128 ((const __m128i *) (line + j)));
+      return;
+    }
+#endif
+  memcpy (D, line, size * sizeof (int));
+}
+
+/**
+ * @brief Worker of SampleSort. Phases (separated by barriers): first-touch its slice of S and classify the elements
+ *        of its chunk of A, counting them by bucket; (worker 0) turn the counts into offsets; scatter the chunk into
+ *        the buckets of S; sort whole buckets, taken largest first, with HybridSort back into A.
+ * @param argument Worker (sampleSortWorkerType).
+ * @return NULL.
+ */
+void *
+sampleSortWorker (void *argument)
+{
+  sampleSortWorkerType *worker = argument;
+  sampleSortType *sort = worker->sort;
+  const int k = sort->numBuckets;
+  const int low = (long long) sort->n * worker->id / sort->numWorkers;
+  const int high = (long long) sort->n * (worker->id + 1) / sort->numWorkers;
+  const int pageElements = sysconf (_SC_PAGESIZE) / sizeof (int);
+  int *counts = sort->counts + worker->id * k;
+  int *lines, *fill;
+  int i, b, w, next, size, start;
+
+  // First touch: a page of S is placed on the NUMA node of the thread writing it first, so every worker places its
+  // own slice (instead of all the pages following the first writer of the scatter).
+  for (i = low; i < high; i += pageElements)
+    sort->S[i] = 0;
+
+  // Classification.
+  for (b = 0; b < k; b++)
+    counts[b] = 0;
+  for (i = low; i < high; i++)
+    {
+      b = sampleSortBucket (sort->tree, k, sort->A[i]);
+      sort->oracle[i] = b;
+      counts[b]++;
+    }
+  pthread_barrier_wait (&sort->barrier);
+
+  // Offsets: buckets one after the other, and inside a bucket the chunks by worker.
+  if (worker->id == 0)
+    {
+      start = 0;
+      for (b = 0; b < k; b++)
+	{
+	  sort->bucketStart[b] = start;
+	  for (w = 0; w < sort->numWorkers; w++)
+	    {
+	      size = sort->counts[w * k + b];
+	      sort->counts[w * k + b] = start;
+	      start += size;
+	    }
+	}
+      sort->bucketStart[k] = start;
+      // Largest buckets first, so that a big bucket does not start last.
+      for (b = 0; b < k; b++)
+	{
+	  size = sort->bucketStart[b + 1] - sort->bucketStart[b];
+	  for (i = b - 1; i >= 0 && sort->bucketStart[sort->order[i] + 1] - sort->bucketStart[sort->order[i]] < size; i--)
+	    sort->order[i + 1] = sort->order[i];
+	  sort->order[i + 1] = b;
+	}
+    }
+  pthread_barrier_wait (&sort->barrier);
+
+  // Distribution: every worker writes its own ranges of S, through a line of buffer for every bucket that is written
+  // when it reaches the end of a cache line of S.
+  lines = malloc (k * sampleSortLineElements * sizeof (int));
+  fill = malloc (k * sizeof (int));
+  for (b = 0; b < k; b++)
+    fill[b] = 0;
+  for (i = low; i < high; i++)
+    {
+      b = sort->oracle[i];
+      lines[b * sampleSortLineElements + fill[b]++] = sort->A[i];
+      if ((counts[b] + fill[b]) % sampleSortLineElements == 0)
+	{
+	  sampleSortFlush (sort->S + counts[b], lines + b * sampleSortLineElements, fill[b]);
+	  counts[b] += fill[b];
+	  fill[b] = 0;
+	}
+    }
+  for (b = 0; b < k; b++)
+    sampleSortFlush (sort->S + counts[b], lines + b * sampleSortLineElements, fill[b]);
+#if defined(__SSE2__)
+  // The non-temporal stores must be visible to the other workers after the barrier.
+  _mm_sfence ();
+#endif
+  free (fill);
+  free (lines);
+  pthread_barrier_wait (&sort->barrier);
+
+  // Local sorts.
+  while ((next = atomic_fetch_add (&sort->nextBucket, 1)) < k)
+    {
+      b = sort->order[next];
+      start = sort->bucketStart[b];
+      size = sort->bucketStart[b + 1] - start;
+      if (size == 0)
+	continue;
+      memcpy (sort->A + start, sort->S + start, size * sizeof (int));
+      pingPongSort (sort->A + start, sort->S + start, 0, size - 1, threshold, true);
+    }
+  return NULL;
+}
+
+/**
+ * @brief Parallel SampleSort: sampleSortOversampling*k random samples give k-1 splitters (k buckets), every thread
+ *        classifies and scatters its chunk of the array into the buckets in one pass, then the threads sort whole
+ *        buckets with HybridSort. It sets sampleSortImbalance.
+ * @param A Array of random numbers to be sorted.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @param threads Number of threads (0 means all the online cores).
+ * @property It takes O(n*logn / threads) expected time with balanced buckets, and n ints plus n bytes of extra memory.
+ */
+void
+sampleSort (int *A, const int p, const int r, const int threads)
+{
+  int n = r - p + 1;
+  int workers = threads > 0 ? threads : (int) sysconf (_SC_NPROCESSORS_ONLN);
+  int k = 2, numSamples, i, b, largest = 0;
+  int *samples;
+  prng_t generator;
+  sampleSortType sort;
+  sampleSortWorkerType *pool;
+  pthread_t *ids;
+  sampleSortImbalance = 1;
+  if (n <= grainSize)
+    {
+      hybridSortBranchless (A, NULL, p, r);
+      return;
+    }
+  while (k < workers * sampleSortBucketsPerThread && k < 256)
+    k *= 2;
+
+  // Splitters: every sampleSortOversampling-th of the sorted samples.
+  numSamples = sampleSortOversampling * k;
+  samples = malloc (numSamples * sizeof (int));
+  prngSeed (&generator, SEED, 0);
+  for (i = 0; i < numSamples; i++)
+    samples[i] = A[p + prngBounded (&generator, n)];
+  hybridSortBranchless (samples, NULL, 0, numSamples - 1);
+  for (b = 1; b < k; b++)
+    samples[b - 1] = samples[b * sampleSortOversampling];
+
+  sort.A = A + p;
+  // Aligned to a cache line, so that the scatter can write whole lines.
+  if (posix_memalign ((void **) &sort.S, 64, n * sizeof (int)) != 0)
+    sort.S = NULL;
+  sort.oracle = malloc (n);
+  sort.n = n;
+  sort.numWorkers = workers;
+  sort.numBuckets = k;
+  sort.tree = malloc (k * sizeof (int));
+  sampleSortBuildTree (sort.tree, 1, samples, 0, k - 2);
+  sort.counts = malloc (workers * k * sizeof (int));
+  sort.bucketStart = malloc ((k + 1) * sizeof (int));
+  sort.order = malloc (k * sizeof (int));
+  atomic_init (&sort.nextBucket, 0);
+  pthread_barrier_init (&sort.barrier, NULL, workers);
+
+  pool = malloc (workers * sizeof (sampleSortWorkerType));
+  ids = malloc (workers * sizeof (pthread_t));
+  for (i = 0; i < workers; i++)
+    {
+      pool[i].sort = &sort;
+      pool[i].id = i;
+    }
+  for (i = 1; i < workers; i++)
+    pthread_create (&ids[i], NULL, sampleSortWorker, &pool[i]);
+  sampleSortWorker (&pool[0]);
+  for (i = 1; i < workers; i++)
+    pthread_join (ids[i], NULL);
+
+  for (b = 0; b < k; b++)
+    if (sort.bucketStart[b + 1] - sort.bucketStart[b] > largest)
+      largest = sort.bucketStart[b + 1] - sort.bucketStart[b];
+  sampleSortImbalance = (double) largest * k / n;
+
+  pthread_barrier_destroy (&sort.barrier);
+  free (ids);
+  free (pool);
+  free (sort.order);
+  free (sort.bucketStart);
+  free (sort.counts);
+  free (sort.tree);
+  free (sort.oracle);
+  free (sort.S);
+  free (samples);
+}
+
+/**
+ * @brief Does the CPU support AVX2? (Checked at runtime, so the same binary runs everywhere.)
+ * @return true if it does; otherwise, false.
+ */
+bool
+cpuHasAvx2 ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_cpu_supports ("avx2");
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Sort a block of 8 elements with the sorting network network8, using branchless compare-exchanges.
+ * @param A Block of 8 elements to be sorted.
+ */
+void
+sortBlock8Scalar (int *A)
+{
+  int c, a, b;
+  for (c = 0; c < 19; c++)
+    {
+      a = A[network8[c][0]];
+      b = A[network8[c][1]];
+      A[network8[c][0]] = a < b ? a : b;
+      A[network8[c][1]] = a < b ? b : a;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * @brief Bitonic cleaner: sort a bitonic vector of 8 elements (compare-exchanges at distance 4, 2 and 1).
+ * @param v Bitonic vector.
+ * @return Sorted vector.
+ */
+__attribute__ ((target ("avx2"))) __m256i
+bitonicCleaner8Avx2 (__m256i v)
+{
+  __m256i t;
+  t = _mm256_permute2x128_si256 (v, v, 1);
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xF0);
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (1, 0, 3, 2));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xCC);
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xAA);
+  return v;
+}
+
+/**
+ * @brief Sort a block of 8 elements inside a register with a bitonic sorting network.
+ * @param A Block of 8 elements to be sorted.
+ */
+__attribute__ ((target ("avx2"))) void
+sortBlock8Avx2 (int *A)
+{
+  __m256i v = _mm256_loadu_si256 ((__m256i *) A);
+  __m256i t;
+  // Sort the pairs.
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xAA);
+  // Merge the pairs into sorted quadruples.
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (0, 1, 2, 3));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xCC);
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xAA);
+  // Merge the quadruples.
+  t = _mm256_permutevar8x32_epi32 (v, _mm256_setr_epi32 (7, 6, 5, 4, 3, 2, 1, 0));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xF0);
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (1, 0, 3, 2));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xCC);
+  t = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1));
+  v = _mm256_blend_epi32 (_mm256_min_epi32 (v, t), _mm256_max_epi32 (v, t), 0xAA);
+  _mm256_storeu_si256 ((__m256i *) A, v);
+}
+
+/**
+ * @brief Merge two sorted arrays whose sizes are multiples of 8, 8 elements at a time with a bitonic merge network.
+ * @param L First sorted array.
+ * @param n1 Size of L (multiple of 8, at least 8).
+ * @param R Second sorted array.
+ * @param n2 Size of R (multiple of 8, at least 8).
+ * @param D Destination array of n1+n2 cells.
+ * @property It takes O(n), where n=n1+n2.
+ */
+__attribute__ ((target ("avx2"))) void
+mergeRunsAvx2 (const int *L, const int n1, const int *R, const int n2, int *D)
+{
+  const __m256i reverse = _mm256_setr_epi32 (7, 6, 5, 4, 3, 2, 1, 0);
+  __m256i a = _mm256_loadu_si256 ((__m256i *) L);
+  __m256i b = _mm256_loadu_si256 ((__m256i *) R);
+  __m256i low, high;
+  int i = 8;
+  int j = 8;
+  int k = 0;
+  while (true)
+    {
+      // The 8 smallest elements of a and b are final; the 8 largest wait for the next block.
+      b = _mm256_permutevar8x32_epi32 (b, reverse);
+      low = bitonicCleaner8Avx2 (_mm256_min_epi32 (a, b));
+      high = bitonicCleaner8Avx2 (_mm256_max_epi32 (a, b));
+      _mm256_storeu_si256 ((__m256i *) (D + k), low);
+      k += 8;
+      a = high;
+      if (i < n1 && (j >= n2 || L[i] <= R[j]))
+	{
+	  b = _mm256_loadu_si256 ((__m256i *) (L + i));
+	  i += 8;
+	}
+      else if (j < n2)
+	{
+	  b = _mm256_loadu_si256 ((__m256i *) (R + j));
+	  j += 8;
+	}
+      else
+	break;
+    }
+  _mm256_storeu_si256 ((__m256i *) (D + k), a);
+}
+
+#endif
+
+/**
+ * @brief NetworkSort algorithm: sorting networks on blocks of 8 elements, then bottom-up merging of the blocks.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param simd true for the AVX2 kernels (only if cpuHasAvx2()); false for the portable scalar ones.
+ * @property It takes O(n*logn), where n=high-low+1 is the size of the input array.
+ */
+void
+networkSortWith (int *A, const int low, const int high, const bool simd)
+{
+  int n = high - low + 1;
+  int padded = (n + 7) / 8 * 8;
+  int local[padded <= 512 ? 2 * padded : 1];
+  int *X, *Y, *T;
+  int i, width, start, n1, n2;
+  if (n <= 1)
+    return;
+  X = padded <= 512 ? local : malloc (2 * padded * sizeof (int));
+  Y = X + padded;
+  // Pad with INT_MAX up to a multiple of 8, so that every block is full.
+  memcpy (X, A + low, n * sizeof (int));
+  for (i = n; i < padded; i++)
+    X[i] = INT_MAX;
+  for (i = 0; i < padded; i += 8)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      if (simd)
+	sortBlock8Avx2 (X + i);
+      else
+#endif
+	sortBlock8Scalar (X + i);
+    }
+  // Bottom-up merging of the sorted blocks, alternating between X and Y.
+  for (width = 8; width < padded; width *= 2)
+    {
+      for (start = 0; start < padded; start += 2 * width)
+	{
+	  n1 = padded - start < width ? padded - start : width;
+	  n2 = padded - start - n1 < width ? padded - start - n1 : width;
+	  if (n2 == 0)
+	    memcpy (Y + start, X + start, n1 * sizeof (int));
+#if defined(__x86_64__) || defined(__i386__)
+	  else if (simd)
+	    mergeRunsAvx2 (X + start, n1, X + start + n1, n2, Y + start);
+#endif
+	  else
+	    mergeRuns (X + start, n1, X + start + n1, n2, Y + start);
+	}
+      T = X;
+      X = Y;
+      Y = T;
+    }
+  memcpy (A + low, X, n * sizeof (int));
+  if (padded > 512)
+    free (X < Y ? X : Y);
+}
+
+/**
+ * @brief NetworkSort algorithm, with the AVX2 kernels if the CPU supports them.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes O(n*logn), where n=high-low+1 is the size of the input array.
+ */
+void
+networkSort (int *A, const int low, const int high)
+{
+  networkSortWith (A, low, high, cpuHasAvx2 ());
+}
+
+/**
+ * @brief HybridSort algorithm with NetworkSort, instead of InsertionSort, as base case.
+ * @param A Array of random numbers to be sorted.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+hybridSortNetwork (int *A, const int p, const int r)
+{
+  int q;
+  if (r - p + 1 > threshold)
+    {
+      q = (p + r) / 2;
+      hybridSortNetwork (A, p, q);	//Ramo sinistro
+      hybridSortNetwork (A, q + 1, r);	//Ramo destro
+      merge (A, p, q, r);
+    }
+  else
+    networkSort (A, p, r);
+}
+
+/**
+ * @brief RadixSort algorithm (LSD, radixBits bits per digit). All the digit histograms are computed in a single pass,
+ *        digits that are equal for every key are skipped, and the passes alternate between A and one buffer.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes O(n*w/radixBits), where n=high-low+1 is the size of the input array and w=32 the bits of a key.
+ */
+void
+radixSort (int *A, const int low, const int high)
+{
+  const int numDigits = (32 + radixBits - 1) / radixBits;
+  const unsigned int mask = (1u << radixBits) - 1;
+  int n = high - low + 1;
+  int i, d, shift;
+  unsigned int key, sum, count;
+  unsigned int (*counts)[1 << radixBits];
+  int *src = A + low;
+  int *dst, *buffer, *T;
+  if (n <= 1)
+    return;
+  counts = calloc (numDigits, sizeof (*counts));
+  // Histogram pass. Flipping the sign bit maps the int order onto the unsigned order.
+  for (i = 0; i < n; i++)
+    {
+      key = (unsigned int) src[i] ^ 0x80000000u;
+      for (d = 0; d < numDigits; d++)
+	counts[d][(key >> (d * radixBits)) & mask]++;
+    }
+  buffer = dst = malloc (n * sizeof (int));
+  for (d = 0; d < numDigits; d++)
+    {
+      shift = d * radixBits;
+      // Trivial digit: every key has the same value, so this pass would not move anything.
+      if (counts[d][(((unsigned int) src[0] ^ 0x80000000u) >> shift) & mask] == (unsigned int) n)
+	continue;
+      // Exclusive prefix sums: first output position of every digit value.
+      sum = 0;
+      for (i = 0; i <= (int) mask; i++)
+	{
+	  count = counts[d][i];
+	  counts[d][i] = sum;
+	  sum += count;
+	}
+      for (i = 0; i < n; i++)
+	{
+	  key = (unsigned int) src[i] ^ 0x80000000u;
+	  dst[counts[d][(key >> shift) & mask]++] = src[i];
+	}
+      T = src;
+      src = dst;
+      dst = T;
+    }
+  if (src != A + low)
+    memcpy (A + low, src, n * sizeof (int));
+  free (buffer);
+  free (counts);
+}
+
+/**
+ * @brief Gallop (exponential, then binary search) for the number of elements of a sorted array that are <= key.
+ * @param key Key to be searched.
+ * @param A Sorted array.
+ * @param n Size of the array.
+ * @return Number of elements of A that are less than or equal to key.
+ * @property It takes O(log k), where k is the returned value.
+ */
+int
+gallopRight (const int key, const int *A, const int n)
+{
+  int low = 0;
+  int high = 1;
+  int mid;
+  while (high < n && A[high - 1] <= key)
+    {
+      low = high;
+      high = 2 * high + 1;
+    }
+  if (high > n)
+    high = n;
+  // Now A[0..low-1] <= key and the answer is in [low, high].
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (A[mid] <= key)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+  return low;
+}
+
+/**
+ * @brief Gallop (exponential, then binary search) for the number of elements of a sorted array that are < key.
+ * @param key Key to be searched.
+ * @param A Sorted array.
+ * @param n Size of the array.
+ * @return Number of elements of A that are less than key.
+ * @property It takes O(log k), where k is the returned value.
+ */
+int
+gallopLeft (const int key, const int *A, const int n)
+{
+  int low = 0;
+  int high = 1;
+  int mid;
+  while (high < n && A[high - 1] < key)
+    {
+      low = high;
+      high = 2 * high + 1;
+    }
+  if (high > n)
+    high = n;
+  // Now A[0..low-1] < key and the answer is in [low, high].
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (A[mid] < key)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+  return low;
+}
+
+/**
+ * @brief TimSort merge of the adjacent sorted runs A[p..p+n1-1] and A[p+n1..p+n1+n2-1], with galloping.
+ * @param A Array containing the runs.
+ * @param p Left-end index of the first run.
+ * @param n1 Size of the first run.
+ * @param n2 Size of the second run.
+ * @param tmp Scratch array of at least n1 cells.
+ * @property It takes O(n) in the worst case and O(log n) when the runs do not interleave, where n=n1+n2.
+ */
+void
+timMerge (int *A, int p, int n1, int n2, int *tmp)
+{
+  int *R = A + p + n1;
+  int *D;
+  int i = 0;
+  int j = 0;
+  int k = 0;
+  int winsL = 0;
+  int winsR = 0;
+  int c1, c2;
+  // Elements of the first run that are already in place.
+  c1 = gallopRight (R[0], A + p, n1);
+  p += c1;
+  n1 -= c1;
+  if (n1 == 0)
+    return;
+  // Elements of the second run that are already in place.
+  n2 = gallopLeft (A[p + n1 - 1], R, n2);
+  if (n2 == 0)
+    return;
+  memcpy (tmp, A + p, n1 * sizeof (int));
+  D = A + p;
+  while (i < n1 && j < n2)
+    {
+      if (winsL >= minGallop || winsR >= minGallop)
+	{
+	  // Galloping mode: copy in bulk the elements of a run preceding the head of the other run.
+	  c1 = gallopRight (R[j], tmp + i, n1 - i);
+	  memcpy (D + k, tmp + i, c1 * sizeof (int));
+	  i += c1;
+	  k += c1;
+	  if (i == n1)
+	    break;
+	  c2 = gallopLeft (tmp[i], R + j, n2 - j);
+	  memmove (D + k, R + j, c2 * sizeof (int));
+	  j += c2;
+	  k += c2;
+	  if (j == n2)
+	    break;
+	  // Back to one element at a time if galloping does not pay off.
+	  if (c1 < minGallop && c2 < minGallop)
+	    winsL = winsR = 0;
+	}
+      if (tmp[i] <= R[j])
+	{
+	  D[k++] = tmp[i++];
+	  winsL++;
+	  winsR = 0;
+	}
+      else
+	{
+	  D[k++] = R[j++];
+	  winsR++;
+	  winsL = 0;
+	}
+    }
+  // The rest of the second run is already in place.
+  memcpy (D + k, tmp + i, (n1 - i) * sizeof (int));
+}
+
+/**
+ * @brief Merge the runs i and i+1 of the TimSort run stack.
+ * @param A Array to be sorted.
+ * @param runBase Left-end indices of the runs.
+ * @param runLength Sizes of the runs.
+ * @param numRuns Number of runs in the stack (decreased by one).
+ * @param i Index of the first run to be merged.
+ * @param tmp Scratch array.
+ */
+void
+timMergeAt (int *A, int *runBase, int *runLength, int *numRuns, const int i,
+	    int *tmp)
+{
+  timMerge (A, runBase[i], runLength[i], runLength[i + 1], tmp);
+  runLength[i] += runLength[i + 1];
+  if (i == *numRuns - 3)
+    {
+      runBase[i + 1] = runBase[i + 2];
+      runLength[i + 1] = runLength[i + 2];
+    }
+  (*numRuns)--;
+}
+
+/**
+ * @brief TimSort algorithm: natural runs (descending ones are reversed) are extended with InsertionSort up to a
+ *        minimum length and merged with galloping, keeping the run lengths balanced on a stack.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes O(n*logn) in the worst case and O(n) on sorted or reverse-sorted input, where n=high-low+1.
+ */
+void
+timSort (int *A, const int low, const int high)
+{
+  int runBase[85];
+  int runLength[85];
+  int numRuns = 0;
+  int n = high - low + 1;
+  int minRun = n;
+  int bits = 0;
+  int start, run, force, i, j, tmp;
+  int *scratch;
+  if (n <= 1)
+    return;
+  // Minimum run length in [32,64], such that n/minRun is (close to) a power of 2.
+  while (minRun >= 64)
+    {
+      bits |= minRun & 1;
+      minRun >>= 1;
+    }
+  minRun += bits;
+  scratch = malloc (n * sizeof (int));
+  for (start = low; start <= high; start += run)
+    {
+      // Find the next run, reversing it if it is strictly descending (to keep the sort stable).
+      run = start + 1;
+      if (run <= high && A[run] < A[start])
+	{
+	  while (run <= high && A[run] < A[run - 1])
+	    run++;
+	  for (i = start, j = run - 1; i < j; i++, j--)
+	    {
+	      tmp = A[i];
+	      A[i] = A[j];
+	      A[j] = tmp;
+	    }
+	}
+      else
+	while (run <= high && A[run] >= A[run - 1])
+	  run++;
+      run -= start;
+      // Extend a short run up to minRun elements.
+      if (run < minRun)
+	{
+	  force = high - start + 1 < minRun ? high - start + 1 : minRun;
+	  insertionSort (A, start, start + force - 1);
+	  run = force;
+	}
+      runBase[numRuns] = start;
+      runLength[numRuns] = run;
+      numRuns++;
+      // Restore the invariants len[i-2] > len[i-1] + len[i] and len[i-1] > len[i] on the stack.
+      while (numRuns > 1)
+	{
+	  i = numRuns - 2;
+	  if ((i > 0 && runLength[i - 1] <= runLength[i] + runLength[i + 1])
+	      || (i > 1 && runLength[i - 2] <= runLength[i - 1] + runLength[i]))
+	    {
+	      if (runLength[i - 1] < runLength[i + 1])
+		i--;
+	    }
+	  else if (runLength[i] > runLength[i + 1])
+	    break;
+	  timMergeAt (A, runBase, runLength, &numRuns, i, scratch);
+	}
+    }
+  // Merge all the remaining runs.
+  while (numRuns > 1)
+    {
+      i = numRuns - 2;
+      if (i > 0 && runLength[i - 1] < runLength[i + 1])
+	i--;
+      timMergeAt (A, runBase, runLength, &numRuns, i, scratch);
+    }
+  free (scratch);
+}
+
+/**
+ * @brief Merge up to bottomUpWays sorted runs, taking at every step the smallest head (the first run on ties).
+ * @param heads Pointers to the first element of every run (advanced by the merge).
+ * @param ends Pointers one past the last element of every run.
+ * @param k Number of runs.
+ * @param D Destination array.
+ * @property It takes O(n*k), where n is the total number of elements.
+ */
+void
+mergeMultiway (const int **heads, const int **ends, int k, int *D)
+{
+  int i, j, best;
+  // Fast path while all 4 runs are non-empty: a branchless tournament (ties go to the leftmost run).
+  while (k == 4 && heads[0] < ends[0] && heads[1] < ends[1]
+	 && heads[2] < ends[2] && heads[3] < ends[3])
+    {
+      i = *heads[1] < *heads[0];
+      j = 2 + (*heads[3] < *heads[2]);
+      best = *heads[j] < *heads[i] ? j : i;
+      *D++ = *heads[best]++;
+    }
+  // Drop the empty runs, keeping the order of the others so that ties still go to the leftmost one.
+  for (i = j = 0; i < k; i++)
+    if (heads[i] < ends[i])
+      {
+	heads[j] = heads[i];
+	ends[j] = ends[i];
+	j++;
+      }
+  k = j;
+  while (k > 1)
+    {
+      best = 0;
+      for (i = 1; i < k; i++)
+	if (*heads[i] < *heads[best])
+	  best = i;
+      *D++ = *heads[best]++;
+      if (heads[best] == ends[best])
+	{
+	  // Keep the order of the remaining runs, so that ties still go to the leftmost one.
+	  for (i = best; i < k - 1; i++)
+	    {
+	      heads[i] = heads[i + 1];
+	      ends[i] = ends[i + 1];
+	    }
+	  k--;
+	}
+    }
+  if (k == 1)
+    memcpy (D, heads[0], (ends[0] - heads[0]) * sizeof (int));
+}
+
+/**
+ * @brief BottomUpSort algorithm: iterative, cache-aware MergeSort. Blocks of l1BlockElements elements are sorted
+ *        in L1 cache with HybridSortBranchless, then every pass merges bottomUpWays runs at a time, alternating
+ *        between A and one buffer.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param passes Number of passes over the whole array (block sorting and merge passes), if not NULL.
+ * @property It takes O(n*logn), with 1+log_4(n/l1BlockElements) passes over memory, where n=high-low+1.
+ */
+void
+bottomUpSort (int *A, const int low, const int high, int *passes)
+{
+  int n = high - low + 1;
+  int *src = A + low;
+  int *buffer, *dst, *T;
+  const int *heads[bottomUpWays];
+  const int *ends[bottomUpWays];
+  int start, end, width, way, begin, numPasses = 0;
+  bool oddPasses = false;
+  if (n <= 1)
+    {
+      if (passes != NULL)
+	*passes = 0;
+      return;
+    }
+  buffer = malloc (n * sizeof (int));
+  // With an odd number of merge passes the sorted blocks go to the buffer, so that the last pass ends in A.
+  for (width = l1BlockElements; width < n; width *= bottomUpWays)
+    oddPasses = !oddPasses;
+  for (start = 0; start < n; start += l1BlockElements)
+    {
+      end = start + l1BlockElements < n ? start + l1BlockElements : n;
+      if (oddPasses)
+	{
+	  // Both arrays hold the block after one copy, as pingPongSort requires (hybridSortBranchless would copy again).
+	  memcpy (buffer + start, src + start, (end - start) * sizeof (int));
+	  pingPongSort (buffer + start, src + start, 0, end - start - 1, threshold, true);
+	}
+      else
+	hybridSortBranchless (src, buffer, start, end - 1);
+    }
+  numPasses++;
+  if (oddPasses)
+    {
+      src = buffer;
+      dst = A + low;
+    }
+  else
+    dst = buffer;
+  for (width = l1BlockElements; width < n; width *= bottomUpWays)
+    {
+      for (start = 0; start < n; start += bottomUpWays * width)
+	{
+	  for (way = 0; way < bottomUpWays; way++)
+	    {
+	      begin = start + way * width;
+	      heads[way] = src + (begin < n ? begin : n);
+	      ends[way] = src + (begin + width < n ? begin + width : n);
+	    }
+	  mergeMultiway (heads, ends, bottomUpWays, dst + start);
+	}
+      T = src;
+      src = dst;
+      dst = T;
+      numPasses++;
+    }
+  free (buffer);
+  if (passes != NULL)
+    *passes = numPasses;
+}
+
+/**
+ * @brief Swap two elements of an array.
+ * @param A Array.
+ * @param i Index of the first element.
+ * @param j Index of the second element.
+ */
+void
+swapElements (int *A, const int i, const int j)
+{
+  int tmp = A[i];
+  A[i] = A[j];
+  A[j] = tmp;
+}
+
+/**
+ * @brief Sort the three elements A[a], A[b] and A[c].
+ * @param A Array.
+ * @param a Index of the first element.
+ * @param b Index of the second element.
+ * @param c Index of the third element.
+ */
+void
+sort3 (int *A, const int a, const int b, const int c)
+{
+  if (A[b] < A[a])
+    swapElements (A, a, b);
+  if (A[c] < A[b])
+    swapElements (A, b, c);
+  if (A[b] < A[a])
+    swapElements (A, a, b);
+}
+
+/**
+ * @brief Sift-down procedure of the max-heap A[low..high].
+ * @param A Array.
+ * @param low Index of the root of the heap.
+ * @param i Index of the element to sift down.
+ * @param high Index of the last element of the heap.
+ */
+void
+heapSiftDown (int *A, const int low, int i, const int high)
+{
+  int child;
+  int value = A[i];
+  while ((child = low + 2 * (i - low) + 1) <= high)
+    {
+      if (child < high && A[child + 1] > A[child])
+	child++;
+      if (A[child] <= value)
+	break;
+      A[i] = A[child];
+      i = child;
+    }
+  A[i] = value;
+}
+
+/**
+ * @brief HeapSort algorithm.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes O(n*logn) in the worst case and O(1) extra memory, where n=high-low+1.
+ */
+void
+heapSort (int *A, const int low, const int high)
+{
+  int i;
+  for (i = low + (high - low + 1) / 2 - 1; i >= low; i--)
+    heapSiftDown (A, low, i, high);
+  for (i = high; i > low; i--)
+    {
+      swapElements (A, low, i);
+      heapSiftDown (A, low, low, i - 1);
+    }
+}
+
+/**
+ * @brief Block partitioning (BlockQuicksort) around the pivot A[low]: the misplaced elements of a block of
+ *        INTRO_BLOCK_SIZE elements on each side are found without branches, storing their offsets, and then swapped
+ *        pairwise; the last (less than two blocks) elements are partitioned in the classic way.
+ * @param A Array.
+ * @param low Left-end index of the array (the pivot).
+ * @param high Right-end index of the array.
+ * @return Final index of the pivot: A[low..index-1] < pivot <= A[index+1..high].
+ * @property It takes O(n), where n=high-low+1.
+ */
+int
+blockPartition (int *A, const int low, const int high)
+{
+  unsigned char offsetsL[INTRO_BLOCK_SIZE];
+  unsigned char offsetsR[INTRO_BLOCK_SIZE];
+  int pivot = A[low];
+  int first = low + 1;
+  int last = high;
+  int numL = 0, numR = 0, startL = 0, startR = 0;
+  int i, num;
+  while (last - first + 1 >= 2 * INTRO_BLOCK_SIZE)
+    {
+      if (numL == 0)
+	{
+	  startL = 0;
+	  for (i = 0; i < INTRO_BLOCK_SIZE; i++)
+	    {
+	      offsetsL[numL] = i;
+	      numL += A[first + i] >= pivot;
+	    }
+	}
+      if (numR == 0)
+	{
+	  startR = 0;
+	  for (i = 0; i < INTRO_BLOCK_SIZE; i++)
+	    {
+	      offsetsR[numR] = i;
+	      numR += A[last - i] < pivot;
+	    }
+	}
+      num = numL < numR ? numL : numR;
+      for (i = 0; i < num; i++)
+	swapElements (A, first + offsetsL[startL + i], last - offsetsR[startR + i]);
+      numL -= num;
+      numR -= num;
+      startL += num;
+      startR += num;
+      if (numL == 0)
+	first += INTRO_BLOCK_SIZE;
+      if (numR == 0)
+	last -= INTRO_BLOCK_SIZE;
+    }
+  // Everything before first is < pivot and everything after last is >= pivot (blocks with pending offsets are
+  // still inside [first, last]), so the rest is partitioned in the classic way.
+  while (true)
+    {
+      while (first <= last && A[first] < pivot)
+	first++;
+      while (first <= last && A[last] >= pivot)
+	last--;
+      if (first > last)
+	break;
+      swapElements (A, first++, last--);
+    }
+  swapElements (A, low, first - 1);
+  return first - 1;
+}
+
+/**
+ * @brief Partition around the pivot A[low] putting the elements equal to it on the left; used when the pivot equals
+ *        the element preceding the range, that is when the left part would contain only copies of the pivot.
+ * @param A Array.
+ * @param low Left-end index of the array (the pivot).
+ * @param high Right-end index of the array.
+ * @return Final index of the pivot: A[low..index] <= pivot < A[index+1..high].
+ * @property It takes O(n), where n=high-low+1.
+ */
+int
+partitionLeft (int *A, const int low, const int high)
+{
+  int pivot = A[low];
+  int first = low + 1;
+  int last = high;
+  while (true)
+    {
+      while (first <= last && A[first] <= pivot)
+	first++;
+      while (first <= last && A[last] > pivot)
+	last--;
+      if (first > last)
+	break;
+      swapElements (A, first++, last--);
+    }
+  swapElements (A, low, first - 1);
+  return first - 1;
+}
+
+/**
+ * @brief Main loop of IntroSort (pattern-defeating variant): recursion on the smaller part, loop on the larger one.
+ * @param A Array.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param badAllowed Number of unbalanced partitions allowed before switching to HeapSort.
+ * @param leftmost true if there is no element before A[low] in the array being sorted.
+ */
+void
+introSortLoop (int *A, int low, int high, int badAllowed, bool leftmost)
+{
+  int n, mid, pivotIndex, sizeL, sizeR;
+  size_t stackUsed = (size_t) (introStackBase - (char *) &n);
+  if (stackUsed > introPeakStack)
+    introPeakStack = stackUsed;
+  while ((n = high - low + 1) > introSortThreshold)
+    {
+      // Pivot: median of 3, or Tukey's ninther for large ranges, moved to A[low].
+      mid = low + n / 2;
+      if (n > nintherThreshold)
+	{
+	  sort3 (A, low, mid, high);
+	  sort3 (A, low + 1, mid - 1, high - 1);
+	  sort3 (A, low + 2, mid + 1, high - 2);
+	  sort3 (A, mid - 1, mid, mid + 1);
+	}
+      else
+	sort3 (A, low, mid, high);
+      swapElements (A, low, mid);
+      // Many copies of the pivot: A[low-1] <= every element of the range, so the ones equal to the pivot are done.
+      if (!leftmost && A[low - 1] == A[low])
+	{
+	  low = partitionLeft (A, low, high) + 1;
+	  continue;
+	}
+      pivotIndex = blockPartition (A, low, high);
+      sizeL = pivotIndex - low;
+      sizeR = high - pivotIndex;
+      // Unbalanced partition: break patterns by swapping a few elements, or give up and use HeapSort.
+      if (sizeL < n / 8 || sizeR < n / 8)
+	{
+	  if (--badAllowed == 0)
+	    {
+	      heapSort (A, low, high);
+	      return;
+	    }
+	  if (sizeL >= introSortThreshold)
+	    {
+	      swapElements (A, low, low + sizeL / 4);
+	      swapElements (A, pivotIndex - 1, pivotIndex - sizeL / 4);
+	    }
+	  if (sizeR >= introSortThreshold)
+	    {
+	      swapElements (A, pivotIndex + 1, pivotIndex + 1 + sizeR / 4);
+	      swapElements (A, high, high - sizeR / 4);
+	    }
+	}
+      if (sizeL < sizeR)
+	{
+	  introSortLoop (A, low, pivotIndex - 1, badAllowed, leftmost);
+	  low = pivotIndex + 1;
+	  leftmost = false;
+	}
+      else
+	{
+	  introSortLoop (A, pivotIndex + 1, high, badAllowed, false);
+	  high = pivotIndex - 1;
+	}
+    }
+  insertionSort (A, low, high);
+}
+
+/**
+ * @brief IntroSort algorithm (pattern-defeating quicksort): in-place and unstable, with ninther pivots, branchless
+ *        block partitioning, InsertionSort for small partitions and HeapSort after log2(n) unbalanced partitions.
+ * @param A Array of random numbers to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes O(n*logn) in the worst case and O(logn) extra memory (stack), where n=high-low+1.
+ */
+void
+introSort (int *A, const int low, const int high)
+{
+  int n = high - low + 1;
+  int logN = 0;
+  char base;
+  while ((n >>= 1) > 0)
+    logN++;
+  introStackBase = &base;
+  introPeakStack = 0;
+  introSortLoop (A, low, high, logN + 1, true);
+}
+
+/**
+ * @brief Sift-up of A[i] in the max-heap A[low..i].
+ * @param A Array.
+ * @param low Left-end index of the heap (the root).
+ * @param i Index of the element to be moved up.
+ */
+void
+heapSiftUp (int *A, const int low, int i)
+{
+  int parent;
+  int value = A[i];
+  while (i > low && A[parent = low + (i - low - 1) / 2] < value)
+    {
+      A[i] = A[parent];
+      i = parent;
+    }
+  A[i] = value;
+}
+
+// Introselect (see below), mutually recursive with floydRivestPivot.
+void nthElementLoop (int *A, int low, int high, const int k, int badAllowed);
+
+/**
+ * @brief Floyd-Rivest step: recursively select the k-th element of a sample range around k, so that A[k] becomes a
+ *        pivot whose rank is very close to k.
+ * @param A Array.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param k Index of the element to be selected (low <= k <= high).
+ * @param badAllowed Number of unbalanced partitions allowed before falling back to HeapSort.
+ */
+void
+floydRivestPivot (int *A, const int low, const int high, const int k, const int badAllowed)
+{
+  double n = high - low + 1;
+  double i = k - low + 1;
+  double z = log (n);
+  double s = 0.5 * exp (2 * z / 3);
+  double sd = 0.5 * sqrt (z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+  int sampleLow = (int) fmax (low, k - i * s / n + sd);
+  int sampleHigh = (int) fmin (high, k + (n - i) * s / n + sd);
+  nthElementLoop (A, sampleLow, sampleHigh, k, badAllowed);
+}
+
+/**
+ * @brief Introselect: partition around a pivot (Floyd-Rivest sample for large ranges, median of 3 otherwise) and
+ *        continue only on the side containing k; InsertionSort for small ranges and HeapSort after too many
+ *        unbalanced partitions.
+ * @param A Array.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param k Index of the element to be selected (low <= k <= high).
+ * @param badAllowed Number of unbalanced partitions allowed before falling back to HeapSort.
+ */
+void
+nthElementLoop (int *A, int low, int high, const int k, int badAllowed)
+{
+  int n, pivotIndex;
+  while ((n = high - low + 1) > introSortThreshold)
+    {
+      // Pivot moved to A[low].
+      if (n > floydRivestThreshold)
+	{
+	  floydRivestPivot (A, low, high, k, badAllowed);
+	  swapElements (A, low, k);
+	}
+      else
+	{
+	  sort3 (A, low, low + n / 2, high);
+	  swapElements (A, low, low + n / 2);
+	}
+      pivotIndex = blockPartition (A, low, high);
+      if (pivotIndex == k)
+	return;
+      // Unbalanced partition (e.g., many equal keys): give up and use HeapSort.
+      if ((pivotIndex - low < n / 8 || high - pivotIndex < n / 8) && --badAllowed == 0)
+	{
+	  heapSort (A, low, high);
+	  return;
+	}
+      if (k < pivotIndex)
+	high = pivotIndex - 1;
+      else
+	low = pivotIndex + 1;
+    }
+  insertionSort (A, low, high);
+}
+
+/**
+ * @brief Selection: rearrange A so that A[k] is the element that would be there if A were sorted, with
+ *        A[0..k-1] <= A[k] <= A[k+1..n-1].
+ * @param A Array.
+ * @param n Size of the array.
+ * @param k Index of the element to be selected (0 <= k < n; e.g., n/2 for the median).
+ * @property It takes O(n) expected time (O(n*logn) in the worst case) and O(logn) extra memory.
+ */
+void
+nthElement (int *A, const int n, const int k)
+{
+  int logN = 0, m = n;
+  if (k < 0 || k >= n)
+    return;
+  while ((m >>= 1) > 0)
+    logN++;
+  nthElementLoop (A, 0, n - 1, k, logN + 1);
+}
+
+/**
+ * @brief Partial sort: the k smallest elements of A, sorted, in A[0..k-1] (the rest in unspecified order).
+ * @param A Array.
+ * @param n Size of the array.
+ * @param k Number of elements to be sorted (0 <= k <= n).
+ * @property It takes O(n + k*logk) expected time and k extra ints of memory.
+ */
+void
+partialSort (int *A, const int n, const int k)
+{
+  if (k <= 0)
+    return;
+  if (k < n)
+    nthElement (A, n, k - 1);
+  hybridSortBranchless (A, NULL, 0, k - 1);
+}
+
+/**
+ * @brief Initialize an empty streaming top-k.
+ * @param topK Streaming top-k.
+ * @param k Number of smallest elements to be kept (at least 1).
+ */
+void
+topKInit (topKType *topK, const int k)
+{
+  topK->k = k;
+  topK->size = 0;
+  topK->heap = malloc (k * sizeof (int));
+}
+
+/**
+ * @brief Push a chunk of the stream into a top-k: an element enters the heap only if it is smaller than the k-th
+ *        smallest element seen so far (the root).
+ * @param topK Streaming top-k.
+ * @param A Chunk of the stream.
+ * @param n Size of the chunk.
+ * @property It takes O(n*logk) in the worst case and O(n) when few elements enter the heap.
+ */
+void
+topKPush (topKType *topK, const int *A, const int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    if (topK->size < topK->k)
+      {
+	topK->heap[topK->size] = A[i];
+	heapSiftUp (topK->heap, 0, topK->size++);
+      }
+    else if (A[i] < topK->heap[0])
+      {
+	topK->heap[0] = A[i];
+	heapSiftDown (topK->heap, 0, 0, topK->size - 1);
+      }
+}
+
+/**
+ * @brief Extract the result of a top-k and free it.
+ * @param topK Streaming top-k.
+ * @param out Array receiving the min(k, number of pushed elements) smallest elements, sorted.
+ * @return Number of elements written into out.
+ */
+int
+topKFinish (topKType *topK, int *out)
+{
+  int size = topK->size;
+  heapSort (topK->heap, 0, size - 1);
+  memcpy (out, topK->heap, size * sizeof (int));
+  free (topK->heap);
+  topK->heap = NULL;
+  topK->size = 0;
+  return size;
+}
+
+/**
+ * @brief Stable InsertionSort of 64-bit keys.
+ * @param A Array of keys to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes time O(n^2), where n=high-low+1 is the size of the input array.
+ */
+void
+insertionSortKeys64 (uint64_t *A, const int low, const int high)
+{
+  int i, j;
+  uint64_t k;
+  for (j = low + 1; j <= high; j++)
+    {
+      k = A[j];
+      for (i = j - 1; i >= low && A[i] > k; i--)
+	A[i + 1] = A[i];
+      A[i + 1] = k;
+    }
+}
+
+/**
+ * @brief Branchless merge of the sorted runs S[p..q] and S[q+1..r] of 64-bit keys into D[p..r] (see mergeBranchless).
+ * @param S Source array containing the two sorted runs.
+ * @param D Destination array.
+ * @param p Left-end index of the first run.
+ * @param q Right-end index of the first run.
+ * @param r Right-end index of the second run.
+ * @property It takes O(n), where n=r-p+1 is the size of the input array.
+ */
+void
+mergeKeys64 (const uint64_t *S, uint64_t *D, const int p, const int q, const int r)
+{
+  const uint64_t *L = S + p;
+  const uint64_t *R = S + q + 1;
+  const uint64_t *endL = S + q + 1;
+  const uint64_t *endR = S + r + 1;
+  uint64_t *out = D + p;
+  uint64_t l, x;
+  int takeRight;
+  while (L < endL && R < endR)
+    {
+      l = *L;
+      x = *R;
+      takeRight = x < l;
+      *out++ = takeRight ? x : l;
+      R += takeRight;
+      L += 1 - takeRight;
+    }
+  memcpy (out, L, (endL - L) * sizeof (uint64_t));
+  memcpy (out + (endL - L), R, (endR - R) * sizeof (uint64_t));
+}
+
+/**
+ * @brief Ping-pong HybridSort of 64-bit keys: sorts D[p..r] using S[p..r] (same elements on entry) as scratch.
+ * @param D Destination array (it holds the sorted output on return).
+ * @param S Scratch array.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+pingPongSortKeys64 (uint64_t *D, uint64_t *S, const int p, const int r)
+{
+  int q;
+  if (r - p + 1 <= recordCutoff)
+    {
+      insertionSortKeys64 (D, p, r);
+      return;
+    }
+  q = (p + r) / 2;
+  pingPongSortKeys64 (S, D, p, q);
+  pingPongSortKeys64 (S, D, q + 1, r);
+  mergeKeys64 (S, D, p, q, r);
+}
+
+/**
+ * @brief Sort an array of 64-bit keys (fast path of recordSort for records that are a bare 64-bit key).
+ * @param A Array of keys to be sorted.
+ * @param n Size of the array.
+ * @property It takes O(n*logn) and n extra keys of memory.
+ */
+void
+sortKeys64 (uint64_t *A, const int n)
+{
+  uint64_t *S;
+  if (n <= 1)
+    return;
+  S = malloc (n * sizeof (uint64_t));
+  memcpy (S, A, n * sizeof (uint64_t));
+  pingPongSortKeys64 (A, S, 0, n - 1);
+  free (S);
+}
+
+/**
+ * @brief Sort an array of 32-bit unsigned keys (fast path of recordSort for records that are a bare 32-bit key).
+ *        Flipping the sign bit maps the unsigned order onto the signed one, so the int kernels do the work.
+ * @param A Array of keys to be sorted.
+ * @param n Size of the array.
+ * @property It takes O(n*logn) and n extra keys of memory.
+ */
+void
+sortKeys32 (uint32_t *A, const int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    A[i] ^= 0x80000000u;
+  hybridSortBranchless ((int *) A, NULL, 0, n - 1);
+  for (i = 0; i < n; i++)
+    A[i] ^= 0x80000000u;
+}
+
+/**
+ * @brief Stable InsertionSort of key+index pairs by key.
+ * @param A Array of pairs to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @property It takes time O(n^2), where n=high-low+1 is the size of the input array.
+ */
+void
+insertionSortKeyIndex (keyIndexType *A, const int low, const int high)
+{
+  int i, j;
+  keyIndexType k;
+  for (j = low + 1; j <= high; j++)
+    {
+      k = A[j];
+      for (i = j - 1; i >= low && A[i].key > k.key; i--)
+	A[i + 1] = A[i];
+      A[i + 1] = k;
+    }
+}
+
+/**
+ * @brief Stable branchless merge of the sorted runs S[p..q] and S[q+1..r] of key+index pairs into D[p..r]: on equal
+ *        keys the pair of the first run comes first.
+ * @param S Source array containing the two sorted runs.
+ * @param D Destination array.
+ * @param p Left-end index of the first run.
+ * @param q Right-end index of the first run.
+ * @param r Right-end index of the second run.
+ * @property It takes O(n), where n=r-p+1 is the size of the input array.
+ */
+void
+mergeKeyIndex (const keyIndexType *S, keyIndexType *D, const int p, const int q, const int r)
+{
+  const keyIndexType *L = S + p;
+  const keyIndexType *R = S + q + 1;
+  const keyIndexType *endL = S + q + 1;
+  const keyIndexType *endR = S + r + 1;
+  keyIndexType *out = D + p;
+  int takeRight;
+  while (L < endL && R < endR)
+    {
+      takeRight = R->key < L->key;
+      *out++ = *(takeRight ? R : L);
+      R += takeRight;
+      L += 1 - takeRight;
+    }
+  memcpy (out, L, (endL - L) * sizeof (keyIndexType));
+  memcpy (out + (endL - L), R, (endR - R) * sizeof (keyIndexType));
+}
+
+/**
+ * @brief Stable ping-pong HybridSort of key+index pairs: sorts D[p..r] using S[p..r] (same elements on entry) as scratch.
+ * @param D Destination array (it holds the sorted output on return).
+ * @param S Scratch array.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+pingPongSortKeyIndex (keyIndexType *D, keyIndexType *S, const int p, const int r)
+{
+  int q;
+  if (r - p + 1 <= recordCutoff)
+    {
+      insertionSortKeyIndex (D, p, r);
+      return;
+    }
+  q = (p + r) / 2;
+  pingPongSortKeyIndex (S, D, p, q);
+  pingPongSortKeyIndex (S, D, q + 1, r);
+  mergeKeyIndex (S, D, p, q, r);
+}
+
+/**
+ * @brief Stable sort of key+index pairs by key (fast path of recordSort, which sorts the pairs of its records).
+ * @param A Array of pairs to be sorted.
+ * @param n Size of the array.
+ * @property It takes O(n*logn) and n extra pairs of memory.
+ */
+void
+sortKeyIndex (keyIndexType *A, const int n)
+{
+  keyIndexType *S;
+  if (n <= 1)
+    return;
+  S = malloc (n * sizeof (keyIndexType));
+  memcpy (S, A, n * sizeof (keyIndexType));
+  pingPongSortKeyIndex (A, S, 0, n - 1);
+  free (S);
+}
+
+/**
+ * @brief Stable InsertionSort of records of width bytes.
+ * @param A Array of records to be sorted.
+ * @param low Left-end index of the array.
+ * @param high Right-end index of the array.
+ * @param width Size of a record in bytes.
+ * @param keyOf Key extractor.
+ * @param tmp Scratch record of width bytes.
+ * @property It takes time O(n^2), where n=high-low+1 is the size of the input array.
+ */
+void
+recordInsertionSort (char *A, const int low, const int high, const size_t width,
+		     const keyExtractorType keyOf, char *tmp)
+{
+  int i, j;
+  uint64_t k;
+  for (j = low + 1; j <= high; j++)
+    {
+      k = keyOf (A + j * width);
+      memcpy (tmp, A + j * width, width);
+      for (i = j - 1; i >= low && keyOf (A + i * width) > k; i--)
+	memcpy (A + (i + 1) * width, A + i * width, width);
+      memcpy (A + (i + 1) * width, tmp, width);
+    }
+}
+
+/**
+ * @brief Stable merge of the sorted runs S[p..q] and S[q+1..r] of records of width bytes into D[p..r].
+ * @param S Source array containing the two sorted runs.
+ * @param D Destination array.
+ * @param p Left-end index of the first run.
+ * @param q Right-end index of the first run.
+ * @param r Right-end index of the second run.
+ * @param width Size of a record in bytes.
+ * @param keyOf Key extractor.
+ * @property It takes O(n), where n=r-p+1 is the size of the input array.
+ */
+void
+recordMerge (const char *S, char *D, const int p, const int q, const int r,
+	     const size_t width, const keyExtractorType keyOf)
+{
+  int i = p;
+  int j = q + 1;
+  int k;
+  for (k = p; k <= r; k++)
+    {
+      if (j > r || (i <= q && keyOf (S + i * width) <= keyOf (S + j * width)))
+	memcpy (D + k * width, S + (i++) * width, width);
+      else
+	memcpy (D + k * width, S + (j++) * width, width);
+    }
+}
+
+/**
+ * @brief Stable ping-pong HybridSort of records of width bytes: sorts D[p..r] using S[p..r] (same records on entry)
+ *        as scratch.
+ * @param D Destination array (it holds the sorted output on return).
+ * @param S Scratch array.
+ * @param p Left-end index of the array.
+ * @param r Right-end index of the array.
+ * @param width Size of a record in bytes.
+ * @param keyOf Key extractor.
+ * @param tmp Scratch record of width bytes.
+ * @property It takes O(n*logn), where n=r-p+1 is the size of the input array.
+ */
+void
+recordPingPongSort (char *D, char *S, const int p, const int r, const size_t width,
+		    const keyExtractorType keyOf, char *tmp)
+{
+  int q;
+  if (r - p + 1 <= recordCutoff)
+    {
+      recordInsertionSort (D, p, r, width, keyOf, tmp);
+      return;
+    }
+  q = (p + r) / 2;
+  recordPingPongSort (S, D, p, q, width, keyOf, tmp);
+  recordPingPongSort (S, D, q + 1, r, width, keyOf, tmp);
+  recordMerge (S, D, p, q, r, width, keyOf);
+}
+
+/**
+ * @brief Stable sort of records of width bytes moving the whole records at every level of the merges (the generic
+ *        version of hybridSortPingPong; see recordSort).
+ * @param base Array of records to be sorted.
+ * @param n Number of records.
+ * @param width Size of a record in bytes.
+ * @param keyOf Key extractor.
+ * @property It takes O(n*logn) key extractions and record copies, and n extra records of memory.
+ */
+void
+recordSortDirect (void *base, const int n, const size_t width, const keyExtractorType keyOf)
+{
+  char *S, *tmp;
+  if (n <= 1)
+    return;
+  S = malloc (n * width);
+  tmp = malloc (width);
+  memcpy (S, base, n * width);
+  recordPingPongSort (base, S, 0, n - 1, width, keyOf, tmp);
+  free (S);
+  free (tmp);
+}
+
+/**
+ * @brief Stable sort of records of width bytes: the key of every record is extracted once into a key+index pair,
+ *        the pairs are sorted (sortKeyIndex), then the records move once by the resulting permutation.
+ * @param base Array of records to be sorted.
+ * @param n Number of records (less than 2^32).
+ * @param width Size of a record in bytes.
+ * @param keyOf Key extractor.
+ * @property It takes O(n*logn), n key extractions, n record copies and n extra records plus 2n pairs of memory.
+ */
+void
+recordSort (void *base, const int n, const size_t width, const keyExtractorType keyOf)
+{
+  char *A = base;
+  keyIndexType *pairs;
+  char *sorted;
+  int i;
+  if (n <= 1)
+    return;
+  pairs = malloc (n * sizeof (keyIndexType));
+  for (i = 0; i < n; i++)
+    {
+      pairs[i].key = keyOf (A + i * width);
+      pairs[i].index = i;
+    }
+  sortKeyIndex (pairs, n);
+  // Apply the permutation: gather the records in sorted order, then copy them back.
+  sorted = malloc (n * width);
+  for (i = 0; i < n; i++)
+    memcpy (sorted + i * width, A + pairs[i].index * width, width);
+  memcpy (A, sorted, n * width);
+  free (sorted);
+  free (pairs);
+}
+
+/**
+ * @brief Polymorphic function that calls different sorting algorithms.
+ * @param randomArray Array of random numbers to be sorted.
+ * @param dim Dimension of the input array.
+ * @param algo Sorting algorithm to be called. The possible values are: insertionSort,
+ *             mergeSort, hybridSort, mergeSortPingPong, hybridSortPingPong, mergeSortBranchless,
+ *             hybridSortBranchless, bottomUpSort, introSort, heapSort, networkSort,
+ *             hybridSortNetwork, radixSort, timSort, parallelHybridSort and sampleSort.
+ * @return Pair containing the time needed to sort (monotonic clock, in nanoseconds), the isSorted flag (sorted and
+ *         with the same elements as the input) and the hardware performance counters of the sort (of the calling
+ *         thread only; unavailable unless measureCounters).
+ */
+pairType
+sortArray (const int *randomArray, const int dim, const char *algo)
+{
+  // Initiliazation of a pairType with values time = 0, isSorted = true and no counters.
+  pairType pair = { 0, true, {{0}} };
+  int i;
+  // Hash of the multiset of the input, checked against the output (outside the timed region).
+  uint64_t inputHash = dim > 0 ? verifyMultisetHash (randomArray, dim, numThreads) : 0;
+  // Start and end time, in nanoseconds.
+  unsigned long long startTime, endTime = 0;
+
+  // Allocate memory for dim integers.
+  int *sliceRandomArray = malloc (dim * sizeof (int));
+  // Put every i-th element of randomArray into sliceRandomArray for each i in [0, ..., dim-1].
+  for (i = 0; i < dim; i++)
+    sliceRandomArray[i] = randomArray[i];
+
+  // Start the counters and the clock.
+  perfCountersStart (&perfCounters);
+  startTime = benchmarkNowNs ();
+  // Use InsertionSort.
+  if (strcmp (algo, "insertionSort") == 0)
+    insertionSort (sliceRandomArray, 0, dim - 1);
+  // Use MergeSort.
+  else if (strcmp (algo, "mergeSort") == 0)
+    mergeSort (sliceRandomArray, 0, dim - 1);
+  // Use HybridSort.
+  else if (strcmp (algo, "hybridSort") == 0)
+    hybridSort (sliceRandomArray, 0, dim - 1);
+  // Use MergeSort with a single scratch buffer.
+  else if (strcmp (algo, "mergeSortPingPong") == 0)
+    mergeSortPingPong (sliceRandomArray, NULL, 0, dim - 1);
+  // Use HybridSort with a single scratch buffer.
+  else if (strcmp (algo, "hybridSortPingPong") == 0)
+    hybridSortPingPong (sliceRandomArray, NULL, 0, dim - 1);
+  // Use MergeSort with the branchless merge kernel.
+  else if (strcmp (algo, "mergeSortBranchless") == 0)
+    mergeSortBranchless (sliceRandomArray, NULL, 0, dim - 1);
+  // Use HybridSort with the branchless merge kernel.
+  else if (strcmp (algo, "hybridSortBranchless") == 0)
+    hybridSortBranchless (sliceRandomArray, NULL, 0, dim - 1);
+  // Use the iterative cache-aware MergeSort.
+  else if (strcmp (algo, "bottomUpSort") == 0)
+    bottomUpSort (sliceRandomArray, 0, dim - 1, NULL);
+  // Use IntroSort.
+  else if (strcmp (algo, "introSort") == 0)
+    introSort (sliceRandomArray, 0, dim - 1);
+  // Use HeapSort.
+  else if (strcmp (algo, "heapSort") == 0)
+    heapSort (sliceRandomArray, 0, dim - 1);
+  // Use NetworkSort.
+  else if (strcmp (algo, "networkSort") == 0)
+    networkSort (sliceRandomArray, 0, dim - 1);
+  // Use HybridSort with NetworkSort as base case.
+  else if (strcmp (algo, "hybridSortNetwork") == 0)
+    hybridSortNetwork (sliceRandomArray, 0, dim - 1);
+  // Use RadixSort.
+  else if (strcmp (algo, "radixSort") == 0)
+    radixSort (sliceRandomArray, 0, dim - 1);
+  // Use TimSort.
+  else if (strcmp (algo, "timSort") == 0)
+    timSort (sliceRandomArray, 0, dim - 1);
+  // Use multithreaded HybridSort.
+  else if (strcmp (algo, "parallelHybridSort") == 0)
+    parallelHybridSort (sliceRandomArray, 0, dim - 1, numThreads);
+  // Use multithreaded SampleSort.
+  else if (strcmp (algo, "sampleSort") == 0)
+    sampleSort (sliceRandomArray, 0, dim - 1, numThreads);
+  // Error
+  else
+    {
+      fprintf (stderr,
+	       "ERROR: There is no such sorting algorithm called %s\n", algo);
+      exit (1);
+    }
+  // Stop the clock and the counters.
+  endTime = benchmarkNowNs ();
+  perfCountersStop (&perfCounters, &pair.counters);
+
+  // Total time needed to sort.
+  pair.time = endTime - startTime;
+  // Have we sorted the instance, without losing or duplicating elements? If not, then the flag is set to false;
+  // otherwise, it remains true.
+  if (!isSorted (sliceRandomArray, dim) || !isPermutation (sliceRandomArray, dim, inputHash))
+    pair.isSorted = false;
+
+  // Free sliceRandomArray.
+  free (sliceRandomArray);
+
+  return pair;
+}
+
+/**
+ * @brief Job of the main experiment: every algorithm sorts its own copy of the same input, drawn from the random
+ *        stream of the job (so that the results do not depend on the thread running it).
+ * @param context Jobs of a size (sortJobsType).
+ * @param job Index of the job.
+ */
+void
+sortJob (void *context, int job)
+{
+  sortJobsType *jobs = context;
+  int *randomArray = malloc (jobs->dim * sizeof (int));
+  // The generator of the thread is replaced by the stream of the job only for the job.
+  prng_t saved = randomGenerator;
+  int a;
+  runnerSeedJob (&randomGenerator, SEED,
+		 (uint64_t) jobs->row * (numWarmupRuns + numExperiments) + job);
+  generateRandomArray (randomArray, jobs->dim);
+  randomGenerator = saved;
+  for (a = 0; a < numAlgorithms; a++)
+    jobs->pairs[job * numAlgorithms + a] =
+      sortArray (randomArray, jobs->dim, algorithms[a]);
+  free (randomArray);
+}
+
+/**
+ * @brief Start of a worker of the main experiment: open its hardware performance counters, if requested.
+ */
+void
+sortJobThreadStart ()
+{
+  if (measureCounters)
+    perfCountersOpen (&perfCounters);
+}
+
+/**
+ * @brief End of a worker of the main experiment: close its hardware performance counters.
+ */
+void
+sortJobThreadEnd ()
+{
+  perfCountersClose (&perfCounters);
+}
+
+/**
+ * @brief One calibration round: time InsertionSort and MergeSort on batches of arrays of sizes
+ *        calibrationStep, 2*calibrationStep, ..., calibrationMaxSize.
+ * @param input Random input of calibrationElements elements.
+ * @param A Working array of calibrationElements elements.
+ * @return The largest size for which InsertionSort is not slower than MergeSort (the crossing point).
+ */
+int
+calibrationRound (const int *input, int *A)
+{
+  int dim, start, crossing = calibrationStep;
+  double startTime, timeIS, timeMS;
+  for (dim = calibrationStep; dim <= calibrationMaxSize; dim += calibrationStep)
+    {
+      memcpy (A, input, calibrationElements * sizeof (int));
+      startTime = wallClockTime ();
+      for (start = 0; start + dim <= calibrationElements; start += dim)
+	insertionSort (A, start, start + dim - 1);
+      timeIS = wallClockTime () - startTime;
+      memcpy (A, input, calibrationElements * sizeof (int));
+      startTime = wallClockTime ();
+      for (start = 0; start + dim <= calibrationElements; start += dim)
+	mergeSort (A, start, start + dim - 1);
+      timeMS = wallClockTime () - startTime;
+      if (timeIS <= timeMS)
+	crossing = dim;
+    }
+  return crossing;
+}
+
+/**
+ * @brief Calibrate threshold on this machine: the median crossing point of up to calibrationRounds rounds,
+ *        within calibrationBudget seconds.
+ * @param confidence Fraction of the rounds whose crossing point is within calibrationStep of the chosen value.
+ * @return Calibrated threshold.
+ */
+int
+calibrateThreshold (double *confidence)
+{
+  int crossings[calibrationRounds];
+  int rounds = 0;
+  int agreeing = 0;
+  int i, j, tmp;
+  double startTime = wallClockTime ();
+  int *input = malloc (calibrationElements * sizeof (int));
+  int *A = malloc (calibrationElements * sizeof (int));
+  // The generator of the thread is replaced by the stream of the calibration only for the input.
+  prng_t saved = randomGenerator;
+  prngSeed (&randomGenerator, SEED, calibrationStream);
+  generateRandomArray (input, calibrationElements);
+  randomGenerator = saved;
+  do
+    crossings[rounds++] = calibrationRound (input, A);
+  while (rounds < calibrationRounds
+	 && wallClockTime () - startTime < calibrationBudget);
+  // Median of the crossing points.
+  for (i = 1; i < rounds; i++)
+    for (j = i; j > 0 && crossings[j - 1] > crossings[j]; j--)
+      {
+	tmp = crossings[j];
+	crossings[j] = crossings[j - 1];
+	crossings[j - 1] = tmp;
+      }
+  for (i = 0; i < rounds; i++)
+    if (abs (crossings[i] - crossings[rounds / 2]) <= calibrationStep)
+      agreeing++;
+  *confidence = (double) agreeing / rounds;
+  free (A);
+  free (input);
+  return crossings[rounds / 2];
+}
+
+/**
+ * @brief Set threshold from thresholdProfileFile or, if missing (or forceCalibration), calibrate it and save the profile.
+ *        The chosen value is printed on the console (on stderr if the output is on file).
+ */
+void
+loadThreshold ()
+{
+  FILE *profile = NULL;
+  FILE *log = outputType == ONCONSOLE ? outputPointer : stderr;
+  int value;
+  double confidence;
+  if (!forceCalibration)
+    profile = fopen (thresholdProfileFile, "r");
+  if (profile != NULL)
+    {
+      if (fscanf (profile, "threshold %d confidence %lf", &value, &confidence) == 2 && value > 0)
+	{
+	  threshold = value;
+	  fprintf (log, "Threshold: %d (from %s, confidence %.2f)\n", threshold,
+		   thresholdProfileFile, confidence);
+	  fclose (profile);
+	  return;
+	}
+      fclose (profile);
+    }
+  if (!calibrateAtStartup && !forceCalibration)
+    {
+      fprintf (log, "Threshold: %d (default)\n", threshold);
+      return;
+    }
+  threshold = calibrateThreshold (&confidence);
+  fprintf (log, "Threshold: %d (calibrated, confidence %.2f)\n", threshold,
+	   confidence);
+  profile = fopen (thresholdProfileFile, "w");
+  if (profile == NULL)
+    {
+      fprintf (stderr, "Error: The profile %s has not been saved\n", thresholdProfileFile);
+      return;
+    }
+  fprintf (profile, "threshold %d\nconfidence %f\n", threshold, confidence);
+  fclose (profile);
+}
+
+// ----- EXTERNAL SORT ----- //
+
+/**
+ * @brief Refill the buffer of a run reader.
+ * @param reader Run reader.
+ * @param stats Statistics to be updated.
+ */
+void
+runReaderFill (runReaderType *reader, externalStatsType *stats)
+{
+  reader->size = fread (reader->buffer, sizeof (int), externalBufferElements,
+			reader->file);
+  reader->position = 0;
+  reader->exhausted = reader->size == 0;
+  stats->bytesRead += (long long) reader->size * sizeof (int);
+}
+
+/**
+ * @brief Write n ints to a file of the external sort, counting only the bytes actually written.
+ * @param A Ints to be written.
+ * @param n Number of ints.
+ * @param file File where the ints are written.
+ * @param stats Statistics to be updated.
+ * @return true if all of them have been written; otherwise (e.g., the disk is full), false.
+ */
+bool
+externalWrite (const int *A, const int n, FILE *file, externalStatsType *stats)
+{
+  int written = fwrite (A, sizeof (int), n, file);
+  stats->bytesWritten += (long long) written * sizeof (int);
+  return written == n;
+}
+
+/**
+ * @brief Does the current element of run a come before the current element of run b? Exhausted runs come last,
+ *        and ties are broken by run index.
+ * @param readers Run readers.
+ * @param a First run.
+ * @param b Second run.
+ * @return true if it does; otherwise, false.
+ */
+bool
+loserTreeBeats (const runReaderType *readers, const int a, const int b)
+{
+  int keyA, keyB;
+  if (readers[a].exhausted)
+    return false;
+  if (readers[b].exhausted)
+    return true;
+  keyA = readers[a].buffer[readers[a].position];
+  keyB = readers[b].buffer[readers[b].position];
+  return keyA < keyB || (keyA == keyB && a < b);
+}
+
+/**
+ * @brief K-way merge of sorted run files with a loser tree. Internal nodes 1..k-1 keep the loser of their match,
+ *        node 0 the overall winner; after a run advances only its leaf-to-root path is replayed.
+ * @param runs Files of the sorted runs, positioned at their beginning.
+ * @param k Number of runs.
+ * @param output File where the merged run is written.
+ * @param stats Statistics to be updated.
+ * @return true if the whole merged run has been written; otherwise (e.g., the disk is full), false.
+ * @property It takes O(n*logk), where n is the total number of elements.
+ */
+bool
+mergeRunFiles (FILE **runs, const int k, FILE *output, externalStatsType *stats)
+{
+  runReaderType *readers = malloc (k * sizeof (runReaderType));
+  int *loser = malloc (k * sizeof (int));
+  int *winner = malloc (2 * k * sizeof (int));
+  int *outBuffer = malloc (externalBufferElements * sizeof (int));
+  int outSize = 0;
+  int i, node, w, tmp;
+  bool written = true;
+  for (i = 0; i < k; i++)
+    {
+      readers[i].file = runs[i];
+      readers[i].buffer = malloc (externalBufferElements * sizeof (int));
+      runReaderFill (&readers[i], stats);
+    }
+  // Build the tree bottom-up: leaves are k..2k-1.
+  for (i = 0; i < k; i++)
+    winner[k + i] = i;
+  for (node = k - 1; node >= 1; node--)
+    {
+      if (loserTreeBeats (readers, winner[2 * node], winner[2 * node + 1]))
+	{
+	  winner[node] = winner[2 * node];
+	  loser[node] = winner[2 * node + 1];
+	}
+      else
+	{
+	  winner[node] = winner[2 * node + 1];
+	  loser[node] = winner[2 * node];
+	}
+    }
+  loser[0] = k > 1 ? winner[1] : 0;
+  while (written && !readers[loser[0]].exhausted)
+    {
+      w = loser[0];
+      outBuffer[outSize++] = readers[w].buffer[readers[w].position++];
+      if (outSize == externalBufferElements)
+	{
+	  written = externalWrite (outBuffer, outSize, output, stats);
+	  outSize = 0;
+	}
+      if (readers[w].position == readers[w].size)
+	runReaderFill (&readers[w], stats);
+      // Replay the matches from the leaf of w to the root.
+      for (node = (w + k) / 2; node >= 1; node /= 2)
+	if (loserTreeBeats (readers, loser[node], w))
+	  {
+	    tmp = loser[node];
+	    loser[node] = w;
+	    w = tmp;
+	  }
+      loser[0] = w;
+    }
+  // The file is flushed too, so that a full disk is detected here rather than when it is read or closed.
+  written = written && externalWrite (outBuffer, outSize, output, stats)
+    && fflush (output) == 0;
+  for (i = 0; i < k; i++)
+    free (readers[i].buffer);
+  free (outBuffer);
+  free (winner);
+  free (loser);
+  free (readers);
+  return written;
+}
+
+/**
+ * @brief External sort of a binary file of ints: runs of externalChunkElements ints are sorted in memory with
+ *        ParallelHybridSort and written to temporary files, then merged externalFanIn at a time until one is left.
+ * @param inputFile Name of the binary file to be sorted.
+ * @param outputFile Name of the binary file where the sorted ints are written.
+ * @param stats Statistics of the sort.
+ * @return true if the sort succeeded; otherwise (e.g., the disk is full, and outputFile is removed), false.
+ */
+bool
+externalSort (const char *inputFile, const char *outputFile,
+	      externalStatsType *stats)
+{
+  FILE *input = fopen (inputFile, "rb");
+  FILE *output;
+  FILE **runs, **merged;
+  int *chunk;
+  int n, i, numRuns, numMerged, group;
+  bool written = true;
+  double startTime = wallClockTime ();
+  memset (stats, 0, sizeof (externalStatsType));
+  if (input == NULL)
+    {
+      fprintf (stderr, "Error: The file %s cannot be read\n", inputFile);
+      return false;
+    }
+  // First pass: sorted runs.
+  chunk = malloc (externalChunkElements * sizeof (int));
+  numRuns = 0;
+  runs = NULL;
+  while (written && (n = fread (chunk, sizeof (int), externalChunkElements, input)) > 0)
+    {
+      stats->bytesRead += (long long) n * sizeof (int);
+      stats->elements += n;
+      parallelHybridSort (chunk, 0, n - 1, numThreads);
+      runs = realloc (runs, (numRuns + 1) * sizeof (FILE *));
+      runs[numRuns] = tmpfile ();
+      if (runs[numRuns] == NULL)
+	{
+	  fprintf (stderr, "Error: The temporary file of a run has not been created\n");
+	  exit (1);
+	}
+      written = externalWrite (chunk, n, runs[numRuns], stats)
+	&& fflush (runs[numRuns]) == 0;
+      rewind (runs[numRuns]);
+      numRuns++;
+    }
+  free (chunk);
+  fclose (input);
+  stats->runs = numRuns;
+  stats->passes = 1;
+  // Merge passes, the last one writing to outputFile.
+  while (written && numRuns > 1)
+    {
+      numMerged = (numRuns + externalFanIn - 1) / externalFanIn;
+      merged = malloc (numMerged * sizeof (FILE *));
+      for (group = 0; group < numMerged; group++)
+	{
+	  output = numMerged == 1 ? fopen (outputFile, "wb") : tmpfile ();
+	  if (output == NULL)
+	    {
+	      fprintf (stderr, "Error: The output of a merge has not been created\n");
+	      exit (1);
+	    }
+	  i = group * externalFanIn;
+	  // After a failed write the other groups are not merged, but their files are still closed.
+	  written = written
+	    && mergeRunFiles (runs + i, numRuns - i < externalFanIn ? numRuns - i : externalFanIn,
+			      output, stats);
+	  for (; i < (group + 1) * externalFanIn && i < numRuns; i++)
+	    fclose (runs[i]);
+	  rewind (output);
+	  merged[group] = output;
+	}
+      free (runs);
+      runs = merged;
+      numRuns = numMerged;
+      stats->passes++;
+    }
+  // A single run is copied to outputFile (an empty input gives an empty file).
+  if (written && stats->passes == 1)
+    {
+      output = fopen (outputFile, "wb");
+      if (output == NULL)
+	{
+	  fprintf (stderr, "Error: The file %s has not been created\n", outputFile);
+	  exit (1);
+	}
+      if (numRuns == 1)
+	{
+	  written = mergeRunFiles (runs, 1, output, stats);
+	  stats->passes++;
+	}
+      written = fclose (output) == 0 && written;
+    }
+  for (i = 0; i < numRuns; i++)
+    written = fclose (runs[i]) == 0 && written;
+  free (runs);
+  stats->seconds = wallClockTime () - startTime;
+  // A short write would leave a truncated output that looks sorted.
+  if (!written)
+    {
+      fprintf (stderr, "Error: The file %s has not been written (e.g., the disk is full)\n", outputFile);
+      remove (outputFile);
+    }
+  return written;
+}
+
+/**
+ * @brief Unit test: check if a binary file of ints is sorted, reading it in blocks.
+ * @param fileName Name of the file.
+ * @param expected Expected number of ints.
+ * @return true if it is sorted and has the expected number of ints; otherwise, false.
+ */
+bool
+isSortedFile (const char *fileName, const long long expected)
+{
+  FILE *file = fopen (fileName, "rb");
+  int *buffer;
+  int n, last = INT_MIN;
+  long long count = 0;
+  bool sorted = true;
+  if (file == NULL)
+    return false;
+  buffer = malloc (externalBufferElements * sizeof (int));
+  while (sorted && (n = fread (buffer, sizeof (int), externalBufferElements, file)) > 0)
+    {
+      if (buffer[0] < last || !isSorted (buffer, n))
+	sorted = false;
+      last = buffer[n - 1];
+      count += n;
+    }
+  free (buffer);
+  fclose (file);
+  return sorted && count == expected;
+}
+
+/**
+ * @brief External sort experiment: sort a file of externalExperimentSize random ints and report throughput and passes.
+ */
+void
+externalExperiment ()
+{
+  externalStatsType stats;
+  FILE *file = fopen (externalInputFile, "wb");
+  int *block = malloc (externalBufferElements * sizeof (int));
+  long long written, n;
+  bool sorted;
+  double megabytes = externalExperimentSize * sizeof (int) / 1e6;
+  if (file == NULL)
+    {
+      fprintf (stderr, "Error: The file %s has not been created\n", externalInputFile);
+      exit (1);
+    }
+  for (written = 0; written < externalExperimentSize; written += n)
+    {
+      n = externalExperimentSize - written < externalBufferElements
+	? externalExperimentSize - written : externalBufferElements;
+      generateRandomArray (block, n);
+      if (fwrite (block, sizeof (int), n, file) != (size_t) n)
+	break;
+    }
+  free (block);
+  if (fclose (file) != 0 || written < externalExperimentSize)
+    {
+      fprintf (stderr, "Error: The file %s has not been written (e.g., the disk is full)\n", externalInputFile);
+      remove (externalInputFile);
+      return;
+    }
+
+  // A short write fails the experiment (externalSort reports it).
+  if (!externalSort (externalInputFile, externalOutputFile, &stats))
+    {
+      remove (externalInputFile);
+      return;
+    }
+  sorted = isSortedFile (externalOutputFile, externalExperimentSize);
+
+  fprintf (outputPointer, "\nExternal sort, chunk of %d ints, fan-in %d\n",
+	   externalChunkElements, externalFanIn);
+  fprintf (outputPointer, "+-----------+-------+--------+-----------+-----------+-----------+-----------+\n");
+  fprintf (outputPointer, "| Size (MB) | Runs  | Passes | I/O (MB)  | Time (s)  | MB/s      | isSorted? |\n");
+  fprintf (outputPointer, "+-----------+-------+--------+-----------+-----------+-----------+-----------+\n");
+  fprintf (outputPointer, "| %9.1f | %5d | %6d | %9.1f | %9.3f | %9.1f | %9s |\n",
+	   megabytes, stats.runs, stats.passes,
+	   (stats.bytesRead + stats.bytesWritten) / 1e6, stats.seconds,
+	   megabytes / stats.seconds, sorted ? "true" : "false");
+  fprintf (outputPointer, "+-----------+-------+--------+-----------+-----------+-----------+-----------+\n");
+
+  remove (externalInputFile);
+  remove (externalOutputFile);
+}
+
+// ----- End EXTERNAL SORT ----- //
+
+/**
+ * @brief Experiment on large arrays: time (in seconds) of the algorithms in largeAlgorithms for sizes
+ *        largeMinSize, 10*largeMinSize, ..., largeMaxSize.
+ */
+void
+largeExperiment ()
+{
+  int dim, a;
+  pairType pair;
+  int *randomArray = malloc (largeMaxSize * sizeof (int));
+
+  fprintf (outputPointer, "\nLarge arrays, time in seconds\n");
+  fprintf (outputPointer, "+-----------+");
+  for (a = 0; a < numLargeAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n| Dimension |");
+  for (a = 0; a < numLargeAlgorithms; a++)
+    fprintf (outputPointer, " %-20s | isSorted? |", largeAlgorithms[a]);
+  fprintf (outputPointer, "\n+-----------+");
+  for (a = 0; a < numLargeAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n");
+  for (dim = largeMinSize; dim <= largeMaxSize; dim *= 10)
+    {
+      generateRandomArray (randomArray, dim);
+      fprintf (outputPointer, "| %9d |", dim);
+      for (a = 0; a < numLargeAlgorithms; a++)
+	{
+	  pair = sortArray (randomArray, dim, largeAlgorithms[a]);
+	  fprintf (outputPointer, " %20f | %9s |",
+		   pair.time / 1e9,
+		   pair.isSorted ? "true" : "false");
+	}
+      fprintf (outputPointer, "\n");
+    }
+  fprintf (outputPointer, "+-----------+");
+  for (a = 0; a < numLargeAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n");
+
+  free (randomArray);
+}
+
+/**
+ * @brief Key extractor of the records whose key is the leading 32-bit unsigned integer.
+ * @param record Record.
+ * @return Key of the record.
+ */
+uint64_t
+recordKey32 (const void *record)
+{
+  uint32_t key;
+  memcpy (&key, record, sizeof (key));
+  return key;
+}
+
+/**
+ * @brief Key extractor of the records whose key is the leading 64-bit unsigned integer.
+ * @param record Record.
+ * @return Key of the record.
+ */
+uint64_t
+recordKey64 (const void *record)
+{
+  uint64_t key;
+  memcpy (&key, record, sizeof (key));
+  return key;
+}
+
+/**
+ * @brief Record experiment: time (in seconds) of the stable record sorts on recordExperimentSize records of each
+ *        width in recordWidths, with about 4 records for each key. The key is the leading 32-bit (width 4) or
+ *        64-bit integer; records of at least 16 bytes carry their input position after the key, so that stability
+ *        can be checked. The fast path is sortKeys32 for width 4 and sortKeys64 for width 8 (bare keys).
+ */
+void
+recordExperiment ()
+{
+  const int numWidths = sizeof (recordWidths) / sizeof (recordWidths[0]);
+  const int n = recordExperimentSize;
+  int w, i, previousPosition = 0, position = 1;
+  size_t width;
+  uint32_t key32;
+  uint64_t key64;
+  double startTime, timeDirect, timeIndirect, timeFast;
+  bool stable;
+  keyExtractorType keyOf;
+  char *input, *direct, *indirect, *fast;
+
+  fprintf (outputPointer, "\nStable record sorts, time in seconds\n");
+  fprintf (outputPointer, "+-------+--------------------+--------------------+--------------------+-----------+\n");
+  fprintf (outputPointer, "| Width | recordSortDirect   | recordSort         | Fast path          | isStable? |\n");
+  fprintf (outputPointer, "+-------+--------------------+--------------------+--------------------+-----------+\n");
+  for (w = 0; w < numWidths; w++)
+    {
+      width = recordWidths[w];
+      keyOf = width < sizeof (uint64_t) ? recordKey32 : recordKey64;
+      input = calloc (n, width);
+      direct = malloc (n * width);
+      indirect = malloc (n * width);
+      fast = malloc (n * width);
+      for (i = 0; i < n; i++)
+	{
+	  if (width < sizeof (uint64_t))
+	    {
+	      key32 = prngBounded (&randomGenerator, n / 4 + 1);
+	      memcpy (input + i * width, &key32, sizeof (key32));
+	    }
+	  else
+	    {
+	      key64 = prngNext (&randomGenerator) % (n / 4 + 1);
+	      memcpy (input + i * width, &key64, sizeof (key64));
+	    }
+	  if (width >= 2 * sizeof (uint64_t))
+	    memcpy (input + i * width + sizeof (uint64_t), &i, sizeof (i));
+	}
+
+      memcpy (direct, input, n * width);
+      startTime = wallClockTime ();
+      recordSortDirect (direct, n, width, keyOf);
+      timeDirect = wallClockTime () - startTime;
+
+      memcpy (indirect, input, n * width);
+      startTime = wallClockTime ();
+      recordSort (indirect, n, width, keyOf);
+      timeIndirect = wallClockTime () - startTime;
+
+      timeFast = -1;
+      memcpy (fast, input, n * width);
+      startTime = wallClockTime ();
+      if (width == sizeof (uint32_t))
+	sortKeys32 ((uint32_t *) fast, n);
+      else if (width == sizeof (uint64_t))
+	sortKeys64 ((uint64_t *) fast, n);
+      if (width <= sizeof (uint64_t))
+	timeFast = wallClockTime () - startTime;
+      else
+	memcpy (fast, direct, n * width);
+
+      // Sorted by key, positions increasing among equal keys, and the same output from every sort.
+      stable = memcmp (direct, indirect, n * width) == 0
+	&& memcmp (direct, fast, n * width) == 0;
+      for (i = 1; i < n && stable; i++)
+	{
+	  if (width >= 2 * sizeof (uint64_t))
+	    {
+	      memcpy (&previousPosition, direct + (i - 1) * width + sizeof (uint64_t), sizeof (int));
+	      memcpy (&position, direct + i * width + sizeof (uint64_t), sizeof (int));
+	    }
+	  stable = keyOf (direct + (i - 1) * width) < keyOf (direct + i * width)
+	    || (keyOf (direct + (i - 1) * width) == keyOf (direct + i * width)
+		&& previousPosition < position);
+	}
+      if (timeFast < 0)
+	fprintf (outputPointer, "| %5zu | %18f | %18f | %18s | %9s |\n", width,
+		 timeDirect, timeIndirect, "n/a", stable ? "true" : "false");
+      else
+	fprintf (outputPointer, "| %5zu | %18f | %18f | %18f | %9s |\n", width,
+		 timeDirect, timeIndirect, timeFast, stable ? "true" : "false");
+
+      free (input);
+      free (direct);
+      free (indirect);
+      free (fast);
+    }
+  fprintf (outputPointer, "+-------+--------------------+--------------------+--------------------+-----------+\n");
+}
+
+/**
+ * @brief Memory experiment: time and peak extra memory of the in-place IntroSort (measured stack) against
+ *        HybridSortBranchless (one buffer of n ints) on large arrays.
+ */
+void
+memoryExperiment ()
+{
+  int dim;
+  pairType pairIntro, pairHS;
+  size_t peakIntro;
+  int *randomArray = malloc (largeMaxSize * sizeof (int));
+
+  fprintf (outputPointer, "\nIn-place sorting, time in seconds and peak extra memory in bytes\n");
+  fprintf (outputPointer, "+-----------+----------------------------------------------+----------------------------------------------+\n");
+  fprintf (outputPointer, "| ######### | introSort                                    | hybridSortBranchless                         |\n");
+  fprintf (outputPointer, "+-----------+--------------+--------------------+-----------+--------------+--------------------+-----------+\n");
+  fprintf (outputPointer, "| Dimension | Time         | Extra memory       | isSorted? | Time         | Extra memory       | isSorted? |\n");
+  fprintf (outputPointer, "+-----------+--------------+--------------------+-----------+--------------+--------------------+-----------+\n");
+  for (dim = largeMinSize; dim <= largeMaxSize; dim *= 10)
+    {
+      generateRandomArray (randomArray, dim);
+      pairIntro = sortArray (randomArray, dim, "introSort");
+      peakIntro = introPeakStack;
+      pairHS = sortArray (randomArray, dim, "hybridSortBranchless");
+      fprintf (outputPointer, "| %9d | %12f | %18zu | %9s | %12f | %18zu | %9s |\n", dim,
+	       pairIntro.time / 1e9, peakIntro,
+	       pairIntro.isSorted ? "true" : "false",
+	       pairHS.time / 1e9, dim * sizeof (int),
+	       pairHS.isSorted ? "true" : "false");
+    }
+  fprintf (outputPointer, "+-----------+--------------+--------------------+-----------+--------------+--------------------+-----------+\n");
+
+  free (randomArray);
+}
+
+/**
+ * @brief Selection experiment: time (in seconds) of the full sort (HybridSortBranchless), partialSort, nthElement
+ *        and the streaming top-k (chunks of topKChunkElements) on selectionExperimentSize random numbers, for the
+ *        values of k in selectionKs and the median.
+ */
+void
+selectionExperiment ()
+{
+  const int numKs = sizeof (selectionKs) / sizeof (selectionKs[0]);
+  const int n = selectionExperimentSize;
+  int i, k, start, chunk;
+  double startTime, timeSort, timePartial, timeNth, timeTopK;
+  bool correct;
+  topKType topK;
+  int *randomArray = malloc (n * sizeof (int));
+  int *sorted = malloc (n * sizeof (int));
+  int *A = malloc (n * sizeof (int));
+  int *top = malloc (n * sizeof (int));
+
+  generateRandomArray (randomArray, n);
+  memcpy (sorted, randomArray, n * sizeof (int));
+  startTime = wallClockTime ();
+  hybridSortBranchless (sorted, NULL, 0, n - 1);
+  timeSort = wallClockTime () - startTime;
+
+  fprintf (outputPointer, "\nSelection, %d elements, time in seconds\n", n);
+  fprintf (outputPointer, "+-----------+----------------------+--------------+--------------+--------------+-----------+\n");
+  fprintf (outputPointer, "| k         | hybridSortBranchless | partialSort  | nthElement   | topK stream  | Correct?  |\n");
+  fprintf (outputPointer, "+-----------+----------------------+--------------+--------------+--------------+-----------+\n");
+  for (i = 0; i <= numKs; i++)
+    {
+      // The last row is the median.
+      k = i < numKs ? selectionKs[i] : n / 2;
+
+      memcpy (A, randomArray, n * sizeof (int));
+      startTime = wallClockTime ();
+      partialSort (A, n, k);
+      timePartial = wallClockTime () - startTime;
+      correct = isPartiallySorted (A, n, k) && memcmp (A, sorted, k * sizeof (int)) == 0;
+
+      memcpy (A, randomArray, n * sizeof (int));
+      startTime = wallClockTime ();
+      nthElement (A, n, k);
+      timeNth = wallClockTime () - startTime;
+      correct = correct && isNthElement (A, n, k) && A[k] == sorted[k];
+
+      startTime = wallClockTime ();
+      topKInit (&topK, k);
+      for (start = 0; start < n; start += chunk)
+	{
+	  chunk = n - start < topKChunkElements ? n - start : topKChunkElements;
+	  topKPush (&topK, randomArray + start, chunk);
+	}
+      correct = correct && topKFinish (&topK, top) == k;
+      timeTopK = wallClockTime () - startTime;
+      correct = correct && memcmp (top, sorted, k * sizeof (int)) == 0;
+
+      fprintf (outputPointer, "| %9d | %20f | %12f | %12f | %12f | %9s |\n", k, timeSort,
+	       timePartial, timeNth, timeTopK, correct ? "true" : "false");
+    }
+  fprintf (outputPointer, "+-----------+----------------------+--------------+--------------+--------------+-----------+\n");
+
+  free (top);
+  free (A);
+  free (sorted);
+  free (randomArray);
+}
+
+/**
+ * @brief Cache experiment: passes over memory and cycles per element of HybridSortBranchless (recursive, 2-way)
+ *        and BottomUpSort (iterative, bottomUpWays-way), for sizes from l1BlockElements to cacheExperimentMaxSize.
+ */
+void
+cacheExperiment ()
+{
+  int dim, passesBU, passesHS, size;
+  unsigned long long startCycles;
+  double startTime, cyclesHS, cyclesBU, nsHS, nsBU;
+  bool sorted;
+  int *randomArray = malloc (cacheExperimentMaxSize * sizeof (int));
+  int *A = malloc (cacheExperimentMaxSize * sizeof (int));
+
+  fprintf (outputPointer, "\nCache behaviour (cycles are time stamp counter cycles)\n");
+  fprintf (outputPointer, "+-----------+-----------+--------------------------------------+--------------------------------------+-----------+\n");
+  fprintf (outputPointer, "| ######### | ######### | hybridSortBranchless                 | bottomUpSort                         | ######### |\n");
+  fprintf (outputPointer, "+-----------+-----------+--------+------------+----------------+--------+------------+----------------+-----------+\n");
+  fprintf (outputPointer, "| Dimension | Size (KB) | Passes | ns/element | cycles/element | Passes | ns/element | cycles/element | isSorted? |\n");
+  fprintf (outputPointer, "+-----------+-----------+--------+------------+----------------+--------+------------+----------------+-----------+\n");
+  for (dim = l1BlockElements; dim <= cacheExperimentMaxSize; dim *= 4)
+    {
+      generateRandomArray (randomArray, dim);
+
+      memcpy (A, randomArray, dim * sizeof (int));
+      startTime = wallClockTime ();
+      startCycles = cycleCounter ();
+      hybridSortBranchless (A, NULL, 0, dim - 1);
+      cyclesHS = (double) (cycleCounter () - startCycles) / dim;
+      nsHS = (wallClockTime () - startTime) * 1e9 / dim;
+      sorted = isSorted (A, dim);
+      // One pass for the base cases, one for every level of 2-way merges.
+      for (passesHS = 1, size = threshold; size < dim; size *= 2)
+	passesHS++;
+
+      memcpy (A, randomArray, dim * sizeof (int));
+      startTime = wallClockTime ();
+      startCycles = cycleCounter ();
+      bottomUpSort (A, 0, dim - 1, &passesBU);
+      cyclesBU = (double) (cycleCounter () - startCycles) / dim;
+      nsBU = (wallClockTime () - startTime) * 1e9 / dim;
+      sorted = sorted && isSorted (A, dim);
+
+      fprintf (outputPointer, "| %9d | %9d | %6d | %10.2f | %14.2f | %6d | %10.2f | %14.2f | %9s |\n",
+	       dim, (int) (dim * sizeof (int) / 1024), passesHS, nsHS, cyclesHS,
+	       passesBU, nsBU, cyclesBU, sorted ? "true" : "false");
+    }
+  fprintf (outputPointer, "+-----------+-----------+--------+------------+----------------+--------+------------+----------------+-----------+\n");
+
+  free (A);
+  free (randomArray);
+}
+
+/**
+ * @brief Adaptivity experiment: time (in seconds) of the algorithms in adaptiveAlgorithms on every input distribution.
+ */
+void
+adaptiveExperiment ()
+{
+  int input, a;
+  pairType pair;
+  int *A = malloc (adaptiveExperimentSize * sizeof (int));
+
+  fprintf (outputPointer, "\nInput distributions, %d elements, time in seconds\n",
+	   adaptiveExperimentSize);
+  fprintf (outputPointer, "+----------------+");
+  for (a = 0; a < numAdaptiveAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n| Input          |");
+  for (a = 0; a < numAdaptiveAlgorithms; a++)
+    fprintf (outputPointer, " %-20s | isSorted? |", adaptiveAlgorithms[a]);
+  fprintf (outputPointer, "\n+----------------+");
+  for (a = 0; a < numAdaptiveAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n");
+  for (input = RANDOM; input <= FEW_UNIQUE; input++)
+    {
+      generateArray (A, adaptiveExperimentSize, input);
+      fprintf (outputPointer, "| %-14s |", inputNames[input]);
+      for (a = 0; a < numAdaptiveAlgorithms; a++)
+	{
+	  pair = sortArray (A, adaptiveExperimentSize, adaptiveAlgorithms[a]);
+	  fprintf (outputPointer, " %20f | %9s |",
+		   pair.time / 1e9,
+		   pair.isSorted ? "true" : "false");
+	}
+      fprintf (outputPointer, "\n");
+    }
+  fprintf (outputPointer, "+----------------+");
+  for (a = 0; a < numAdaptiveAlgorithms; a++)
+    fprintf (outputPointer, "----------------------+-----------+");
+  fprintf (outputPointer, "\n");
+
+  free (A);
+}
+
+/**
+ * @brief Base case experiment: nanoseconds per element of InsertionSort and of NetworkSort (scalar and AVX2) up to threshold.
+ */
+void
+baseCaseExperiment ()
+{
+  int dim, run, algo;
+  bool simd = cpuHasAvx2 ();
+  double startTime, nsPerElement[3];
+  int *input = malloc (baseCaseExperimentRuns * threshold * sizeof (int));
+  int *A = malloc (baseCaseExperimentRuns * threshold * sizeof (int));
+
+  fprintf (outputPointer, "\nBase case, ns per element (AVX2 %s)\n",
+	   simd ? "available" : "not available");
+  fprintf (outputPointer, "+-----------+-------------------+-------------------+-------------------+\n");
+  fprintf (outputPointer, "| Dimension | InsertionSort     | Network (scalar)  | Network (AVX2)    |\n");
+  fprintf (outputPointer, "+-----------+-------------------+-------------------+-------------------+\n");
+  for (dim = 8; dim <= threshold; dim += 8)
+    {
+      generateRandomArray (input, baseCaseExperimentRuns * dim);
+      for (algo = 0; algo < 3; algo++)
+	{
+	  nsPerElement[algo] = 0;
+	  if (algo == 2 && !simd)
+	    continue;
+	  memcpy (A, input, baseCaseExperimentRuns * dim * sizeof (int));
+	  startTime = wallClockTime ();
+	  for (run = 0; run < baseCaseExperimentRuns; run++)
+	    {
+	      if (algo == 0)
+		insertionSort (A + run * dim, 0, dim - 1);
+	      else
+		networkSortWith (A + run * dim, 0, dim - 1, algo == 2);
+	    }
+	  nsPerElement[algo] = (wallClockTime () - startTime) * 1e9
+	    / ((double) baseCaseExperimentRuns * dim);
+	  for (run = 0; run < baseCaseExperimentRuns; run++)
+	    if (!isSorted (A + run * dim, dim))
+	      nsPerElement[algo] = -1;
+	}
+      fprintf (outputPointer, "| %9d | %17f | %17f | %17f |\n", dim,
+	       nsPerElement[0], nsPerElement[1], nsPerElement[2]);
+    }
+  fprintf (outputPointer, "+-----------+-------------------+-------------------+-------------------+\n");
+  fprintf (outputPointer, "(-1 means that the output was not sorted; 0 means not available)\n");
+
+  free (A);
+  free (input);
+}
+
+/**
+ * @brief Speedup experiment: wall-clock time of ParallelHybridSort with 1..N threads against the sequential HybridSort.
+ */
+void
+parallelExperiment ()
+{
+  int threads, run;
+  int maxThreads = (int) sysconf (_SC_NPROCESSORS_ONLN);
+  double startTime, timeHS, timePHS;
+  bool sorted;
+  int *randomArray = malloc (parallelExperimentSize * sizeof (int));
+  int *A = malloc (parallelExperimentSize * sizeof (int));
+
+  generateRandomArray (randomArray, parallelExperimentSize);
+
+  // Sequential baseline.
+  timeHS = 0;
+  sorted = true;
+  for (run = 0; run < parallelExperimentRuns; run++)
+    {
+      memcpy (A, randomArray, parallelExperimentSize * sizeof (int));
+      startTime = wallClockTime ();
+      hybridSort (A, 0, parallelExperimentSize - 1);
+      timeHS += wallClockTime () - startTime;
+      sorted = sorted && isSorted (A, parallelExperimentSize);
+    }
+  timeHS /= parallelExperimentRuns;
+
+  fprintf (outputPointer, "\nParallelHybridSort, %d elements, grain size %d\n",
+	   parallelExperimentSize, grainSize);
+  fprintf (outputPointer, "+------------+-------------------+-----------+-----------+\n");
+  fprintf (outputPointer, "| Threads    | Wall time (s)     | Speedup   | isSorted? |\n");
+  fprintf (outputPointer, "+------------+-------------------+-----------+-----------+\n");
+  fprintf (outputPointer, "| sequential | %17f | %9.2f | %9s |\n", timeHS, 1.0,
+	   sorted ? "true" : "false");
+  for (threads = 1; threads <= maxThreads; threads++)
+    {
+      timePHS = 0;
+      sorted = true;
+      for (run = 0; run < parallelExperimentRuns; run++)
+	{
+	  memcpy (A, randomArray, parallelExperimentSize * sizeof (int));
+	  startTime = wallClockTime ();
+	  parallelHybridSort (A, 0, parallelExperimentSize - 1, threads);
+	  timePHS += wallClockTime () - startTime;
+	  sorted = sorted && isSorted (A, parallelExperimentSize);
+	}
+      timePHS /= parallelExperimentRuns;
+      fprintf (outputPointer, "| %10d | %17f | %9.2f | %9s |\n", threads,
+	       timePHS, timeHS / timePHS, sorted ? "true" : "false");
+    }
+  fprintf (outputPointer, "+------------+-------------------+-----------+-----------+\n");
+
+  free (A);
+  free (randomArray);
+}
+
+/**
+ * @brief Scaling experiment of SampleSort: wall time and speedup against HybridSortBranchless for 1..all threads,
+ *        for sizes sampleSortMinSize, 10*sampleSortMinSize, ..., sampleSortMaxSize and the distributions in
+ *        sampleSortInputs, with the imbalance of the buckets (largest bucket over an even bucket).
+ */
+void
+sampleSortExperiment ()
+{
+  const int numInputs = sizeof (sampleSortInputs) / sizeof (sampleSortInputs[0]);
+  int maxThreads = (int) sysconf (_SC_NPROCESSORS_ONLN);
+  int in, dim, threads;
+  double startTime, timeHS, timeSS;
+  bool sorted;
+  int *input = malloc (sampleSortMaxSize * sizeof (int));
+  int *A = malloc (sampleSortMaxSize * sizeof (int));
+
+  fprintf (outputPointer, "\nSampleSort, wall time in seconds (threads 0 is the sequential hybridSortBranchless)\n");
+  fprintf (outputPointer, "+----------------+------------+---------+-------------------+-----------+-----------+-----------+\n");
+  fprintf (outputPointer, "| Input          | Dimension  | Threads | Wall time (s)     | Speedup   | Imbalance | isSorted? |\n");
+  fprintf (outputPointer, "+----------------+------------+---------+-------------------+-----------+-----------+-----------+\n");
+  for (in = 0; in < numInputs; in++)
+    for (dim = sampleSortMinSize; dim <= sampleSortMaxSize; dim *= 10)
+      {
+	generateArray (input, dim, sampleSortInputs[in]);
+	memcpy (A, input, dim * sizeof (int));
+	startTime = wallClockTime ();
+	hybridSortBranchless (A, NULL, 0, dim - 1);
+	timeHS = wallClockTime () - startTime;
+	sorted = isSorted (A, dim);
+	fprintf (outputPointer, "| %-14s | %10d | %7d | %17f | %9.2f | %9s | %9s |\n",
+		 inputNames[sampleSortInputs[in]], dim, 0, timeHS, 1.0, "-",
+		 sorted ? "true" : "false");
+	for (threads = 1; threads <= maxThreads; threads++)
+	  {
+	    memcpy (A, input, dim * sizeof (int));
+	    startTime = wallClockTime ();
+	    sampleSort (A, 0, dim - 1, threads);
+	    timeSS = wallClockTime () - startTime;
+	    sorted = isSorted (A, dim);
+	    fprintf (outputPointer, "| %-14s | %10d | %7d | %17f | %9.2f | %9.2f | %9s |\n",
+		     inputNames[sampleSortInputs[in]], dim, threads, timeSS,
+		     timeHS / timeSS, sampleSortImbalance, sorted ? "true" : "false");
+	  }
+	if (dim > sampleSortMaxSize / 10)
+	  break;
+      }
+  fprintf (outputPointer, "+----------------+------------+---------+-------------------+-----------+-----------+-----------+\n");
+
+  free (A);
+  free (input);
+}
+
+// ----- End CORE FUNCTIONS ----- //
+
+// ----- MAIN FUNCTION ----- //
+
+/**
+ * @brief Print a horizontal separator of the results table.
+ * @param first Separator of the Dimension column.
+ * @param other Separator of each algorithm column (followed by the ones of the counters if measureCounters).
+ */
+void
+printTableSeparator (const char *first, const char *other)
+{
+  int a, c;
+  fprintf (outputPointer, "%s", first);
+  for (a = 0; a < numAlgorithms; a++)
+    {
+      fprintf (outputPointer, "%s", other);
+      for (c = 0; measureCounters && c < PERF_NUM_COUNTERS; c++)
+	fprintf (outputPointer, "---------------+");
+    }
+  fprintf (outputPointer, "\n");
+}
+
+/**
+ * @brief Main function.
+ * @param argc Number of arguments.
+ * @param argv Options overriding the parameters (see --help).
+ * @return Exit code 0.
+ */
+int
+main (int argc, char **argv)
+{
+  int dim, a, c;
+  // Parameters from the command line and the config file (it exits on --help or on invalid options).
+  optionsParse (argc, argv, options, numOptions);
+  // The options are valid one by one, but the sweep also needs them to be consistent.
+  if (granularity <= 0 || minSize > maxSize || numExperiments < 1
+      || numWarmupRuns < 0)
+    {
+      fprintf (stderr,
+	       "Error: The granularity (%d) and the experiments (%d) must be positive, the warmups (%d) not negative, and the minimum size (%d) at most the maximum size (%d)\n",
+	       granularity, numExperiments, numWarmupRuns, minSize, maxSize);
+      exit (1);
+    }
+  // Initialize the generator of the inputs only once.
+  prngSeed (&randomGenerator, SEED, 0);
+  // The ordered inputs must spread over the keys even with more elements than maxRandInt.
+  if (checkInputs)
+    {
+      const int n = maxRandInt <= INT_MAX / 2 ? 2 * maxRandInt : INT_MAX;
+      if (!checkSortedInputs (n))
+	{
+	  fprintf (stderr, "Error: The sorted inputs of size %d are not correct\n", n);
+	  exit (1);
+	}
+    }
+  // Times of the runs, one set of samples for each algorithm in algorithms.
+  benchmarkSamples_t samples[numAlgorithms];
+  // Statistics of the samples.
+  benchmarkStats_t stats;
+  // Machine-readable output.
+  FILE *benchmarkPointer;
+  // Hardware performance counters accumulated over the runs, one for each algorithm in algorithms.
+  perfValues_t counterSums[numAlgorithms];
+  // Flags saying either that the output of the execution is correct or not.
+  bool areSorted[numAlgorithms];
+  // Runs of a size (warmups first), numAlgorithms pairs for each run.
+  sortJobsType jobs;
+  // Runner of the jobs of the experiment.
+  runner_t runner;
+  // Index of a run in jobs.
+  int job;
+
+  // Allocate the results of all the runs of a size.
+  jobs.pairs =
+    malloc ((numWarmupRuns + numExperiments) * numAlgorithms *
+	    sizeof (pairType));
+
+  // What is the outputPointer?
   if (outputType == ONCONSOLE || outputType == ONFILE)
     {
       // On console.
@@ -371,77 +4230,172 @@ main ()
       exit (1);
     }
 
+  // Pin the experiment to a core, if requested.
+  if (pinCore >= 0 && !benchmarkPinToCore (pinCore))
+    fprintf (stderr, "Error: The experiment has not been pinned to core %d\n",
+	     pinCore);
+  // Open the machine-readable output, if requested.
+  benchmarkPointer = benchmarkOpen (benchmarkFile, benchmarkFormat);
+  for (a = 0; a < numAlgorithms; a++)
+    benchmarkSamplesInit (&samples[a]);
+  // Open the hardware performance counters, if requested (the unavailable ones are shown as n/a).
+  if (measureCounters)
+    {
+      c = perfCountersOpen (&perfCounters);
+      if (c < PERF_NUM_COUNTERS)
+	fprintf (stderr,
+		 "Error: Only %d of %d hardware performance counters are available\n",
+		 c, PERF_NUM_COUNTERS);
+    }
+
+  // Threshold of HybridSort for this machine.
+  if (optionsGiven (options, numOptions, "threshold"))
+    fprintf (outputType == ONCONSOLE ? outputPointer : stderr,
+	     "Threshold: %d (from the options)\n", threshold);
+  else
+    loadThreshold ();
+  // Threads of the (size, repetition) jobs, pinned to the allowed (or isolated) cores.
+  runnerInit (&runner, experimentThreads, isolatedCoresOnly,
+	      sortJobThreadStart, sortJobThreadEnd);
+
   // // Print the header, only if it is on console.
   if (outputType == ONCONSOLE)
     {
-      fprintf (outputPointer,
-	       "+-----------+-------------------------------+-------------------------------+-------------------------------+\n");
-      fprintf (outputPointer,
-	       "| ######### | InsertionSort                 | MergeSort                     | HybridSort                    |\n");
-      fprintf (outputPointer,
-	       "+-----------+-------------------+-----------+-------------------+-----------+-------------------+-----------+\n");
-      fprintf (outputPointer,
-	       "| Dimension | Time              | isSorted? | Time              | isSorted? | Time              | isSorted? |\n");
-      fprintf (outputPointer,
-	       "+-----------+-------------------+-----------+-------------------+-----------+-------------------+-----------+\n");
+      printTableSeparator ("+-----------+",
+			   "-------------------------------+");
+      fprintf (outputPointer, "| ######### |");
+      for (a = 0; a < numAlgorithms; a++)
+	{
+	  fprintf (outputPointer, " %-29s |", algorithms[a]);
+	  for (c = 0; measureCounters && c < PERF_NUM_COUNTERS; c++)
+	    fprintf (outputPointer, "%15s|", "");
+	}
+      fprintf (outputPointer, "\n");
+      printTableSeparator ("+-----------+",
+			   "-------------------+-----------+");
+      fprintf (outputPointer, "| Dimension |");
+      for (a = 0; a < numAlgorithms; a++)
+	{
+	  fprintf (outputPointer, " Median time (ns)  | isSorted? |");
+	  if (measureCounters)
+	    perfHeaderPrint (outputPointer, "", " |");
+	}
+      fprintf (outputPointer, "\n");
+      printTableSeparator ("+-----------+",
+			   "-------------------+-----------+");
     }
 
   // Going from minSize to maxSize with step equal to granularity.
   for (dim = minSize; dim <= maxSize; dim += granularity)
     {
-      // Reset the accumulated times from one experiment to another.
-      timeIS = 0;		// InsertionSort
-      timeMS = 0;		// MergeSort
-      timeHS = 0;		// HybridSort
-      // Reset the isSorted flag for InsertionSort from one experiment to another.
+      // Reset the samples from one experiment to another.
+      // Reset the isSorted flag of every algorithm from one experiment to another.
       // We set this flag to true at the beginning, then if at least one time
-      // the InsertionSort algorithm fails to sort the input such flag will be
-      // set to false; otherwise, it remains true. Similarly for the other algorithms.
-      isSortedIS = true;	// InsertionSort
-      isSortedMS = true;	// MergeSort
-      isSortedHS = true;	// HybridSort
-
-      // Repeat the experiment a numExperiments times for the fixed size (dim).
-      for (exper = 0; exper < numExperiments; exper++)
+      // the algorithm fails to sort the input such flag will be
+      // set to false; otherwise, it remains true.
+      for (a = 0; a < numAlgorithms; a++)
 	{
-	  // Fill the array with (pseudo-) random numbers. That is, initialize only the
-	  // prefix of size dim (<= maxSize) with random numbers.
-	  generateRandomArray (randomArray, dim);
-
-	  // InsertionSort.
-	  pairIS = sortArray (randomArray, dim, "insertionSort");
-	  timeIS += pairIS.time;
-	  isSortedIS = pairIS.isSorted;
-
-	  // MergeSort.
-	  pairMS = sortArray (randomArray, dim, "mergeSort");
-	  timeMS += pairMS.time;
-	  isSortedMS = pairMS.isSorted;
-      // HybridSort.
-	  pairHS = sortArray (randomArray, dim, "hybridSort");
-	  timeHS += pairHS.time;
-	  isSortedHS = pairHS.isSorted;
-
-
+	  benchmarkSamplesReset (&samples[a]);
+	  perfValuesReset (&counterSums[a]);
+	  areSorted[a] = true;
 	}
-      // Printing the (sample mean as) result. Use TAB (\t) on file.
+
+      // Repeat the experiment a numExperiments times for the fixed size (dim),
+      // after numWarmupRuns untimed runs. The runs are independent jobs, each
+      // with its own input, and their results are read in the serial order.
+      jobs.dim = dim;
+      jobs.row = (dim - minSize) / granularity;
+      runnerRun (&runner, numWarmupRuns + numExperiments, sortJob, &jobs);
+      for (job = 0; job < numWarmupRuns + numExperiments; job++)
+	for (a = 0; a < numAlgorithms; a++)
+	  {
+	    if (job >= numWarmupRuns)
+	      {
+		benchmarkSamplesAdd (&samples[a],
+				     jobs.pairs[job * numAlgorithms + a].time);
+		perfValuesAdd (&counterSums[a],
+			       &jobs.pairs[job * numAlgorithms + a].counters);
+	      }
+	    areSorted[a] = areSorted[a]
+	      && jobs.pairs[job * numAlgorithms + a].isSorted;
+	  }
+      // Printing the (sample median as) result. Use TAB (\t) on file.
       if (outputType == ONCONSOLE)
-	fprintf (outputPointer, "| %9d | %17f | %9s | %17f | %9s | %17f | %9s |\n", dim, (double) timeIS / numExperiments, isSortedIS ? "true" : "false",	// InsertionSort
-		 (double) timeMS / numExperiments, isSortedMS ? "true" : "false",	// MergeSort
-		 (double) timeHS / numExperiments, isSortedHS ? "true" : "false");	// HybridSort
+	fprintf (outputPointer, "| %9d |", dim);
       else
-	fprintf (outputPointer, "%9d\t %17f\t %9s\t %17f\t %9s\t %17f\t %9s\n", dim, (double) timeIS / numExperiments, isSortedIS ? "true" : "false",	// InsertionSort
-		 (double) timeMS / numExperiments, isSortedMS ? "true" : "false",	// MergeSort
-		 (double) timeHS / numExperiments, isSortedHS ? "true" : "false");	// HybridSort
+	fprintf (outputPointer, "%9d", dim);
+      for (a = 0; a < numAlgorithms; a++)
+	{
+	  stats = benchmarkComputeStats (&samples[a]);
+	  if (outputType == ONCONSOLE)
+	    fprintf (outputPointer, " %17f | %9s |", stats.median,
+		     areSorted[a] ? "true" : "false");
+	  else
+	    fprintf (outputPointer, "\t %17f\t %9s", stats.median,
+		     areSorted[a] ? "true" : "false");
+	  // Mean hardware performance counters of a run.
+	  if (measureCounters)
+	    perfValuesPrint (outputPointer, &counterSums[a], numExperiments,
+			     outputType == ONCONSOLE ? "" : "\t",
+			     outputType == ONCONSOLE ? " |" : "");
+	  // All the statistics go to the machine-readable output.
+	  benchmarkWrite (benchmarkPointer, benchmarkFormat, "sort",
+			  algorithms[a], dim, &stats);
+	}
+      fprintf (outputPointer, "\n");
     }
 
   // Print the ending part, only if it is on console.
   if (outputType == ONCONSOLE)
-    fprintf (outputPointer,
-	     "+-----------+-------------------+-----------+-------------------+-----------+-------------------+-----------+\n");
+    printTableSeparator ("+-----------+",
+			 "-------------------+-----------+");
+
+  // Large arrays.
+  if (runLargeExperiment)
+    largeExperiment ();
+
+  // Top-k and selection against a full sort.
+  if (runSelectionExperiment)
+    selectionExperiment ();
+
+  // Stable sorts of records of several widths.
+  if (runRecordExperiment)
+    recordExperiment ();
+
+  // Extra memory of the in-place sort.
+  if (runMemoryExperiment)
+    memoryExperiment ();
+
+  // Passes over memory and cycles per element.
+  if (runCacheExperiment)
+    cacheExperiment ();
+
+  // Input distributions.
+  if (runAdaptiveExperiment)
+    adaptiveExperiment ();
+
+  // Time per element of the base cases.
+  if (runBaseCaseExperiment)
+    baseCaseExperiment ();
+
+  // Speedup of the multithreaded HybridSort.
+  if (runParallelExperiment)
+    parallelExperiment ();
+
+  // Scaling of SampleSort.
+  if (runSampleSortExperiment)
+    sampleSortExperiment ();
+
+  // Sort of a file larger than the memory budget.
+  if (runExternalExperiment)
+    externalExperiment ();
 
   // Free the allocated memory.
-  free (randomArray);
+  free (jobs.pairs);
+  for (a = 0; a < numAlgorithms; a++)
+    benchmarkSamplesFree (&samples[a]);
+  benchmarkClose (benchmarkPointer);
+  perfCountersClose (&perfCounters);
 
   // If the output is on file, we need to close the file.
   if (outputType == ONFILE)
@@ -6,21 +6,72 @@
 
 // ##### LIBRARIES ##### //
 
+// GNU extensions (e.g., sched_setaffinity); it must precede every include.
+#define _GNU_SOURCE
 // Standard input-output library (e.g., fprintf).
 #include <stdio.h>
 // Time library (e.g., time, clock()).
 #include <time.h>
-// Standard library (e.g., rand, srand).
+// Standard library (e.g., malloc, free).
 #include <stdlib.h>
 // Boolean library (e.g., bool).
 #include <stdbool.h>
 // String library (e.g., strcmp)
 #include <string.h>
+// Standard definitions library (e.g., max_align_t).
+#include <stddef.h>
+// Limits library (e.g., INT_MAX).
+#include <limits.h>
+// Benchmark harness (e.g., benchmarkNowNs, benchmarkComputeStats).
+#include "benchmark.h"
+// Hardware performance counters (e.g., perfCountersStart, perfCountersStop).
+#include "perfcounters.h"
+// Pseudo-random number generator (e.g., prngSeed, prngFill).
+#include "prng.h"
+// Verification of the outputs (e.g., verifyIsSorted).
+#include "verify.h"
+// Parallel experiment runner (e.g., runnerRun, runnerSeedJob).
+#include "runner.h"
+// Runtime parameters (e.g., optionsParse).
+#include "options.h"
+#ifdef __SSE2__
+// SSE2 intrinsics (e.g., _mm_cmpeq_epi8, _mm_movemask_epi8).
+#include <emmintrin.h>
+#endif
 
 // ##### End of LIBRARIES ##### //
 
 // ##### DATA STRUCTURES ##### //
 
+// ----- NODE POOL ----- //
+
+// Number of nodes of the first chunk of a node pool (the next chunks double, up to NODE_POOL_MAX_CHUNK_NODES).
+#define NODE_POOL_FIRST_CHUNK_NODES 64
+// Maximum number of nodes of a chunk of a node pool.
+#define NODE_POOL_MAX_CHUNK_NODES 65536
+
+/**
+ * @brief Node pool data type: nodes of one size handed out from contiguous chunks, with a free list of the released
+ *        ones; all the chunks are freed together.
+ */
+typedef struct nodePool_t
+{
+    // Size of a node (at least a pointer, which links the free nodes).
+    size_t nodeSize;
+    // Released nodes, linked through their first bytes.
+    void *freeList;
+    // Next never used node of the current chunk.
+    char *next;
+    // End of the current chunk.
+    char *end;
+    // Number of nodes of the next chunk.
+    size_t chunkNodes;
+    // Last chunk: each chunk starts with a pointer to the previous one.
+    void **chunks;
+} nodePool_t;
+
+// ----- End of NODE POOL ----- //
+
 // ----- LINKED LIST ----- //
 
 /**
@@ -45,12 +96,18 @@ typedef struct linkedList_t
     unsigned int size;
     // Pointer to the head node of the list.
     struct linkedListNode_t *head;
+    // Pool of the nodes (NULL: they are allocated with malloc).
+    struct nodePool_t *pool;
 } linkedList_t;
 
 // ----- End of LINKED LIST ----- //
 
 // ----- HASHTABLE ----- //
 
+// Number of searches of a batch whose traversals are interleaved (hashtableSearchBatch, rbtSearchBatch): larger
+// batches are searched in groups of this size.
+#define SEARCH_BATCH_GROUP 64
+
 /**
  * @brief Hashtable entry data type.
  */
@@ -69,10 +126,56 @@ typedef struct hashtable_t
     unsigned int size;
     // Array of pointers to entries.
     struct hashtableEntry_t **entry;
+    // Number of values in the hashtable.
+    unsigned int count;
+    // Does the hashtable resize itself to keep its load factor in [HASHTABLE_MIN_LOAD, HASHTABLE_MAX_LOAD]?
+    bool resizable;
+    // Initial size: the hashtable never shrinks below it.
+    unsigned int minSize;
+    // Size in number of entries of the old hashtable while resizing (0 otherwise).
+    unsigned int oldSize;
+    // Array of pointers to the entries of the old hashtable while resizing (NULL otherwise).
+    struct hashtableEntry_t **oldEntry;
+    // Number of old entries already moved: the new entries exist only for them.
+    unsigned int migrated;
+    // Pool of the nodes of all the lists (NULL: they are allocated with malloc).
+    struct nodePool_t *pool;
 } hashtable_t;
 
 // ----- End of HASHTABLE ----- //
 
+// ----- SWISS TABLE ----- //
+
+// Number of slots of a group, whose control bytes are probed at once.
+#define SWISSTABLE_GROUP 16
+// Control byte of an empty slot (high bit set, so that it is told from a full slot).
+#define SWISSTABLE_EMPTY ((int8_t)0x80)
+// Control byte of a deleted slot (tombstone): the probes go on past it.
+#define SWISSTABLE_DELETED ((int8_t)0xFE)
+
+/**
+ * @brief Swiss table data type: open addressing over groups of SWISSTABLE_GROUP slots, with one control byte for each
+ *        slot (SWISSTABLE_EMPTY, SWISSTABLE_DELETED, or the low 7 bits of the hash of the key, which rule out almost all
+ *        the other keys of the group without reading them).
+ */
+typedef struct swisstable_t
+{
+    // Size in number of slots of the swiss table (numGroups * SWISSTABLE_GROUP).
+    unsigned int capacity;
+    // Number of groups.
+    unsigned int numGroups;
+    // Number of keys.
+    unsigned int size;
+    // Number of deleted slots.
+    unsigned int tombstones;
+    // Control bytes, one for each slot (aligned to a group).
+    int8_t *control;
+    // Keys, one for each slot (flat: no pointers to follow).
+    int *keys;
+} swisstable_t;
+
+// ----- End of SWISS TABLE ----- //
+
 // ----- RED BLACK TREE (RBT) ----- //
 
 /**
@@ -103,6 +206,8 @@ typedef struct rbt_t
     struct rbtNode_t *root;
     // Pointer to RBT NIL node.
     struct rbtNode_t *nil;
+    // Pool of the nodes, except NIL (NULL: they are allocated with malloc).
+    struct nodePool_t *pool;
 } rbt_t;
 
 /**
@@ -118,6 +223,47 @@ typedef struct rbtTestStructure_t
 
 // ----- End of RBT ----- //
 
+// ----- B+ TREE ----- //
+
+// Number of keys of a node: 32 keys fill two cache lines, and they are all compared at once.
+#define BTREE_KEYS 32
+// Alignment of the nodes (a cache line), so that the keys of a node span as few lines as possible.
+#define BTREE_ALIGNMENT 64
+// Minimum number of keys of a node other than the root: deletions borrow from or merge with a sibling below it.
+#define BTREE_MIN_KEYS (BTREE_KEYS / 2)
+
+/**
+ * @brief B+ tree node data type: up to BTREE_KEYS sorted keys, stored contiguously and searched without following
+ *        pointers; the keys are in the leaves, the inner nodes hold copies that route the searches.
+ */
+typedef struct btreeNode_t
+{
+    // Keys, sorted (the unused ones are INT_MAX).
+    int keys[BTREE_KEYS];
+    // Number of keys.
+    int numKeys;
+    // Is the node a leaf?
+    bool leaf;
+    // Children of an inner node (numKeys + 1), where children[i] has the keys in [keys[i - 1], keys[i]]; a leaf has
+    // only children[0], the next leaf (NULL for the last one).
+    struct btreeNode_t *children[];
+} btreeNode_t;
+
+/**
+ * @brief B+ tree data type.
+ */
+typedef struct btree_t
+{
+    // Number of keys of the B+ tree.
+    unsigned int size;
+    // Number of levels of the B+ tree (1: the root is a leaf).
+    unsigned int height;
+    // Pointer to the root node.
+    struct btreeNode_t *root;
+} btree_t;
+
+// ----- End of B+ TREE ----- //
+
 // ----- AUXILIARY DATA STRUCTURES ----- //
 
 /**
@@ -129,6 +275,48 @@ typedef enum outputEnum_t
     ONFILE     // On file.
 } outputEnum_t;
 
+/**
+ * @brief Enumeration data type for the operations of the experiment.
+ */
+typedef enum operationEnum_t
+{
+    INSERTION, // Insert the key.
+    SEARCH,    // Search for the key.
+    DELETION   // Search for the key and delete the node found, if any.
+} operationEnum_t;
+
+/**
+ * @brief Jobs of one number of operations: job j is the experiment exper = j + 1 - NUM_WARMUP_RUNS on all the data
+ *        structures, with its own keys.
+ */
+typedef struct operationsJobs_t
+{
+    // Number of insert operations.
+    unsigned int numInsertions;
+    // Number of search operations.
+    unsigned int numSearches;
+    // Number of delete operations.
+    unsigned int numDeletions;
+    // Index of the number of operations in the sweep (it makes the random streams of the jobs unique).
+    int row;
+    // Elapsed times with the hashtable, one for each job.
+    unsigned long long *timesHashtable;
+    // Elapsed times with the RBT, one for each job.
+    unsigned long long *timesRbt;
+    // Elapsed times with the swiss table, one for each job.
+    unsigned long long *timesSwisstable;
+    // Elapsed times with the B+ tree, one for each job.
+    unsigned long long *timesBtree;
+    // Hardware performance counters with the hashtable, one for each job.
+    perfValues_t *countersHashtable;
+    // Hardware performance counters with the RBT, one for each job.
+    perfValues_t *countersRbt;
+    // Hardware performance counters with the swiss table, one for each job.
+    perfValues_t *countersSwisstable;
+    // Hardware performance counters with the B+ tree, one for each job.
+    perfValues_t *countersBtree;
+} operationsJobs_t;
+
 // ----- End of AUXILIARY DATA STRUCTURES ----- //
 
 // ##### End of DATA STRUCTURES ##### //
@@ -138,47 +326,181 @@ typedef enum outputEnum_t
 // Random seed (important for reproducibility).
 time_t RANDOM_SEED = 20;
 // Maximum random number allowed.
-const unsigned int MAX_RANDOM_NUMBER = 1000;
+unsigned int MAX_RANDOM_NUMBER = 1000;
 // Minimum number of operations.
-const unsigned int MIN_OPERATIONS = 100;
+unsigned int MIN_OPERATIONS = 100;
 // Maximum number of operations.
-const unsigned int MAX_OPERATIONS = 1000;
+unsigned int MAX_OPERATIONS = 1000;
 // Step of the experiment.
-const unsigned int STEP = 100;
+unsigned int STEP = 100;
 // Number of experiments.
-const unsigned int NUM_EXPERIMENTS = 100;
+unsigned int NUM_EXPERIMENTS = 100;
+// Number of untimed warmup experiments before the NUM_EXPERIMENTS timed ones.
+unsigned int NUM_WARMUP_RUNS = 10;
+// Core the experiment is pinned to (a negative value leaves it unpinned).
+int PIN_CORE = -1;
+// Machine-readable output of the statistics of the experiment (in addition to the table).
+benchmarkFormat_t BENCHMARK_FORMAT = BENCHMARK_NONE;
+// File of the machine-readable output.
+char *BENCHMARK_FILE = "results.csv";
+// Measure the hardware performance counters of doExperiment (extra columns of the table)?
+bool MEASURE_COUNTERS = false;
 // Percentage of insert operations.
-const unsigned int PERCENTAGE_INSERTIONS = 40;
+unsigned int PERCENTAGE_INSERTIONS = 40;
+// Percentage of delete operations (the others are searches). With deletions, the operations are interleaved in a
+// random order; with as many insertions as deletions, the size of the structures stays stable.
+unsigned int PERCENTAGE_DELETIONS = 0;
+// Number of random keys inserted before the timed operations (e.g., the steady-state size of the structures).
+unsigned int PREFILL_KEYS = 0;
 // Size of the hashtable.
-const unsigned int NUM_ENTRIES = 1;
+unsigned int NUM_ENTRIES = 1;
+// Resize the hashtable of the experiment to keep its load factor in [HASHTABLE_MIN_LOAD, HASHTABLE_MAX_LOAD] (false:
+// it keeps NUM_ENTRIES entries)?
+bool HASHTABLE_RESIZABLE = false;
+// Load factor (values for each entry) above which a resizable hashtable doubles.
+double HASHTABLE_MAX_LOAD = 1.0;
+// Load factor below which a resizable hashtable halves, down to its initial size (0: it never shrinks).
+double HASHTABLE_MIN_LOAD = 0.25;
+// Old entries moved by each operation while a hashtable resizes (0: all of them at once).
+unsigned int HASHTABLE_REHASH_STEP = 2;
+// Allocate the nodes of the hashtable and of the RBT of the experiment from node pools (false: one malloc each)?
+bool NODE_POOLS = false;
+// Run the resize experiment (latency of each insertion, static vs resizable hashtable; off by default, see --run-resize)?
+bool RUN_RESIZE_EXPERIMENT = false;
+// Number of insertions of the resize experiment.
+unsigned int RESIZE_EXPERIMENT_INSERTIONS = 1000000;
+// Run the B+ tree experiment (time and cache misses of a search as the B+ tree and the RBT grow; off by default, see
+// --run-btree)?
+bool RUN_BTREE_EXPERIMENT = false;
+// Number of keys the B+ tree experiment grows to, by factors of 10 from 1000 (e.g., 100000000).
+unsigned int BTREE_EXPERIMENT_MAX_KEYS = 10000000;
+// Number of keys beyond which the B+ tree experiment stops growing the RBT (its nodes take more memory).
+unsigned int BTREE_EXPERIMENT_MAX_RBT_KEYS = 10000000;
+// Number of searches for each size of the B+ tree experiment.
+unsigned int BTREE_EXPERIMENT_SEARCHES = 1000000;
+// Run the batch experiment (time of a search one at a time and in batches, in structures larger than the caches; off
+// by default, see --run-batch)?
+bool RUN_BATCH_EXPERIMENT = false;
+// Number of keys of the hashtable (with as many entries) and of the RBT of the batch experiment.
+unsigned int BATCH_EXPERIMENT_KEYS = 4000000;
+// Number of searches for each batch size of the batch experiment.
+unsigned int BATCH_EXPERIMENT_SEARCHES = 1000000;
 // Test data structures?
-const bool TEST_DATA_STRUCTURES = true;
+bool TEST_DATA_STRUCTURES = true;
 // Number of elements for testing.
-const unsigned int NUM_ELEMENTS_FOR_TEST = 500;
+unsigned int NUM_ELEMENTS_FOR_TEST = 500;
 // Output type.
-const outputEnum_t outputType = ONCONSOLE;
+outputEnum_t outputType = ONCONSOLE;
 
 // Output pointer (for printing).
 FILE *outputPointer;
+// Hardware performance counters of the current thread (opened by main and by the workers of the runner if MEASURE_COUNTERS).
+_Thread_local perfCounters_t perfCounters;
+// Generator of the keys of the current thread (stream 0 of RANDOM_SEED for the main thread).
+_Thread_local prng_t randomGenerator = PRNG_INITIALIZER;
+// Number of threads running the (number of operations, repetition) jobs (1: serial, 0: one for each core).
+int EXPERIMENT_THREADS = 1;
+// Pin the threads of the experiment only to the isolated cores (isolcpus=), so that the timings stay clean?
+bool ISOLATED_CORES_ONLY = false;
+// Matrix run: values of NUM_ENTRIES iterated in one process (empty: NUM_ENTRIES only).
+optionList_t MATRIX_ENTRIES = {0, {0}};
+// Matrix run: values of PERCENTAGE_INSERTIONS iterated in one process for each value of MATRIX_ENTRIES (empty:
+// PERCENTAGE_INSERTIONS only).
+optionList_t MATRIX_INSERTIONS = {0, {0}};
+// Names of the output types, in the order of outputEnum_t.
+const char *const OUTPUT_NAMES[] = {"console", "file", NULL};
+// Runtime parameters: the globals above that can be set from the command line or a config file (see options.h).
+option_t options[] = {
+    {"seed", OPTION_TIME, &RANDOM_SEED, "Seed of the keys", NULL, false},
+    {"max-random-number", OPTION_UINT, &MAX_RANDOM_NUMBER, "Maximum key", NULL, false},
+    {"min-operations", OPTION_UINT, &MIN_OPERATIONS, "Minimum number of operations", NULL, false},
+    {"max-operations", OPTION_UINT, &MAX_OPERATIONS, "Maximum number of operations", NULL, false},
+    {"step", OPTION_UINT, &STEP, "Step between two numbers of operations", NULL, false},
+    {"experiments", OPTION_UINT, &NUM_EXPERIMENTS, "Number of timed experiments for each number of operations", NULL, false},
+    {"warmups", OPTION_UINT, &NUM_WARMUP_RUNS, "Number of untimed experiments for each number of operations", NULL, false},
+    {"entries", OPTION_UINT, &NUM_ENTRIES, "Size m of the hashtable", NULL, false},
+    {"resizable", OPTION_BOOL, &HASHTABLE_RESIZABLE, "Resize the hashtable with its load factor (m is the initial size)", NULL, false},
+    {"max-load", OPTION_DOUBLE, &HASHTABLE_MAX_LOAD, "Load factor above which a resizable hashtable doubles", NULL, false},
+    {"min-load", OPTION_DOUBLE, &HASHTABLE_MIN_LOAD, "Load factor below which a resizable hashtable halves (0: never)", NULL, false},
+    {"rehash-step", OPTION_UINT, &HASHTABLE_REHASH_STEP, "Old entries moved by each operation while resizing (0: all at once)", NULL, false},
+    {"node-pools", OPTION_BOOL, &NODE_POOLS, "Allocate the nodes of the hashtable and of the RBT from node pools", NULL, false},
+    {"run-resize", OPTION_BOOL, &RUN_RESIZE_EXPERIMENT, "Run the resize experiment", NULL, false},
+    {"resize-insertions", OPTION_UINT, &RESIZE_EXPERIMENT_INSERTIONS, "Number of insertions of the resize experiment", NULL, false},
+    {"run-btree", OPTION_BOOL, &RUN_BTREE_EXPERIMENT, "Run the B+ tree experiment", NULL, false},
+    {"btree-max-keys", OPTION_UINT, &BTREE_EXPERIMENT_MAX_KEYS, "Number of keys the B+ tree experiment grows to", NULL, false},
+    {"btree-max-rbt-keys", OPTION_UINT, &BTREE_EXPERIMENT_MAX_RBT_KEYS, "Number of keys beyond which the B+ tree experiment stops growing the RBT", NULL, false},
+    {"btree-searches", OPTION_UINT, &BTREE_EXPERIMENT_SEARCHES, "Number of searches for each size of the B+ tree experiment", NULL, false},
+    {"run-batch", OPTION_BOOL, &RUN_BATCH_EXPERIMENT, "Run the batch experiment", NULL, false},
+    {"batch-keys", OPTION_UINT, &BATCH_EXPERIMENT_KEYS, "Number of keys of the structures of the batch experiment", NULL, false},
+    {"batch-searches", OPTION_UINT, &BATCH_EXPERIMENT_SEARCHES, "Number of searches for each batch size of the batch experiment", NULL, false},
+    {"insertions", OPTION_UINT, &PERCENTAGE_INSERTIONS, "Percentage of insert operations", NULL, false},
+    {"deletions", OPTION_UINT, &PERCENTAGE_DELETIONS, "Percentage of delete operations (interleaved at random)", NULL, false},
+    {"prefill", OPTION_UINT, &PREFILL_KEYS, "Keys inserted before the timed operations", NULL, false},
+    {"matrix-entries", OPTION_LIST, &MATRIX_ENTRIES, "Matrix run: values of m (e.g., 1,10,100)", NULL, false},
+    {"matrix-insertions", OPTION_LIST, &MATRIX_INSERTIONS, "Matrix run: percentages of insert operations (e.g., 20,40,60)", NULL, false},
+    {"experiment-threads", OPTION_INT, &EXPERIMENT_THREADS, "Threads running the jobs (1: serial, 0: all the cores)", NULL, false},
+    {"isolated-cores", OPTION_BOOL, &ISOLATED_CORES_ONLY, "Run the jobs only on the isolated cores", NULL, false},
+    {"pin-core", OPTION_INT, &PIN_CORE, "Core the experiment is pinned to (-1: unpinned)", NULL, false},
+    {"counters", OPTION_BOOL, &MEASURE_COUNTERS, "Measure the hardware performance counters", NULL, false},
+    {"benchmark-format", OPTION_ENUM, &BENCHMARK_FORMAT, "Machine-readable output of the statistics", benchmarkFormatNames, false},
+    {"benchmark-file", OPTION_STRING, &BENCHMARK_FILE, "File of the machine-readable output", NULL, false},
+    {"output", OPTION_ENUM, &outputType, "Output of the tables (file: results.txt)", OUTPUT_NAMES, false},
+    {"test", OPTION_BOOL, &TEST_DATA_STRUCTURES, "Test the data structures", NULL, false},
+    {"test-elements", OPTION_UINT, &NUM_ELEMENTS_FOR_TEST, "Number of elements for testing", NULL, false}};
+// Number of runtime parameters.
+const int NUM_OPTIONS = sizeof(options) / sizeof(options[0]);
 
 // ##### End of GLOBAL VARIABLES #####
 
 // ##### PROTOTYPES OF THE FUNCTIONS ##### //
 
+// ----- NODE POOL ----- //
+
+/**
+ * @brief Create a new node pool.
+ * @param Size of a node.
+ * @return Created node pool.
+ */
+nodePool_t *createNodePool(const size_t);
+
+/**
+ * @brief Allocate a node from the node pool: a released one if any, otherwise the next one of the current chunk.
+ * @param The node pool.
+ * @return Allocated node.
+ */
+void *nodePoolAlloc(nodePool_t *);
+
+/**
+ * @brief Release a node to the node pool.
+ * @param The node pool.
+ * @param Node to be released.
+ */
+void nodePoolFree(nodePool_t *, void *);
+
+/**
+ * @brief Free the node pool with all its nodes at once.
+ * @param Node pool to be freed.
+ */
+void nodePoolRelease(nodePool_t *);
+
+// ----- End of NODE POOL ----- //
+
 // ----- LINKED LIST ----- //
 
 /**
  * @brief Create a new linked list node.
+ * @param Pool of the node (NULL: malloc).
  * @param Value that the linked list node should contain.
  * @return Created linked list node.
  */
-linkedListNode_t *createLinkedListNode(const int);
+linkedListNode_t *createLinkedListNode(nodePool_t *, const int);
 
 /**
  * @brief Create a new linked list.
+ * @param Pool of the nodes (NULL: malloc).
  * @return Created linked list.
  */
-linkedList_t *createLinkedList();
+linkedList_t *createLinkedList(nodePool_t *);
 
 /**
  * @brief Insert linked list node in the head of the linked list.
@@ -221,9 +543,11 @@ void linkedListFree(linkedList_t *);
 /**
  * @brief Create a new hashtable.
  * @param The size of the hashtable (i.e., the number of entries).
+ * @param Does it resize itself with its load factor (from the given size)?
+ * @param Are the nodes allocated from a node pool of the hashtable?
  * @return The created hashtable.
  */
-hashtable_t *createHashtable(const unsigned int);
+hashtable_t *createHashtable(const unsigned int, const bool, const bool);
 
 /**
  * @brief Hash function computing the key for a given integer.
@@ -233,6 +557,36 @@ hashtable_t *createHashtable(const unsigned int);
  */
 const unsigned int hashFunction(hashtable_t *, const int);
 
+/**
+ * @brief Find the pointer to the entry of a value: while resizing, it is in the old entries until its old entry has
+ *        been moved.
+ * @param The hashtable.
+ * @param The value.
+ * @return Address of the pointer to the entry that contains (or would contain) the value.
+ */
+hashtableEntry_t **hashtableSlot(hashtable_t *, const int);
+
+/**
+ * @brief Find the list of a value: while resizing, it is in the old entries until its old entry has been moved.
+ * @param The hashtable.
+ * @param The value.
+ * @return The list that contains (or would contain) the value.
+ */
+linkedList_t *hashtableBucket(hashtable_t *, const int);
+
+/**
+ * @brief Start resizing the hashtable: the values are moved by the next operations (see hashtableRehashStep).
+ * @param The hashtable.
+ * @param New size of the hashtable.
+ */
+void hashtableResize(hashtable_t *, const unsigned int);
+
+/**
+ * @brief Move HASHTABLE_REHASH_STEP old entries (all of them if 0) of a resizing hashtable to the new entries.
+ * @param The hashtable.
+ */
+void hashtableRehashStep(hashtable_t *);
+
 /**
  * @brief Insert value in the hashtable.
  * @param The hashtable.
@@ -248,6 +602,15 @@ void hashtableInsert(hashtable_t *, const int);
  */
 linkedListNode_t *hashtableSearch(hashtable_t *, const int);
 
+/**
+ * @brief Search for a batch of values in the hashtable, interleaving their traversals with prefetches.
+ * @param The hashtable.
+ * @param Values to be searched.
+ * @param Number of values.
+ * @param Linked list node containing each value, if it exists; otherwise, NULL (output).
+ */
+void hashtableSearchBatch(hashtable_t *, const int *, const unsigned int, linkedListNode_t **);
+
 /**
  * @brief Delete value from hashtable.
  * @param The hashtable.
@@ -275,20 +638,96 @@ void hashtableFree(hashtable_t *);
 
 // ----- End of HASHTABLE ----- //
 
+// ----- SWISS TABLE ----- //
+
+/**
+ * @brief Create a new swiss table.
+ * @param Minimum size of the swiss table (i.e., the number of slots), rounded up to a multiple of SWISSTABLE_GROUP.
+ * @return The created swiss table.
+ */
+swisstable_t *createSwisstable(const unsigned int);
+
+/**
+ * @brief Hash function computing the 64-bit hash of a given integer (multiplicative).
+ * @param The integer for which the hash must be computed.
+ * @return The computed hash: the high 32 bits choose the first group, the low 7 bits are the control byte.
+ */
+uint64_t swisstableHash(const int);
+
+/**
+ * @brief Find the slots of a group whose control byte is a given one (SSE2, when available).
+ * @param Control bytes of the group.
+ * @param Control byte to be found.
+ * @return Bit mask of the slots of the group with such control byte.
+ */
+unsigned int swisstableMatch(const int8_t *, const int8_t);
+
+/**
+ * @brief Find the slots of a group that are empty or deleted (i.e., whose control byte has the high bit set).
+ * @param Control bytes of the group.
+ * @return Bit mask of such slots of the group.
+ */
+unsigned int swisstableMatchFree(const int8_t *);
+
+/**
+ * @brief Rebuild the swiss table with a number of groups, dropping the tombstones.
+ * @param The swiss table.
+ * @param New number of groups.
+ */
+void swisstableRehash(swisstable_t *, const unsigned int);
+
+/**
+ * @brief Insert value in the swiss table (like hashtableInsert, duplicates are kept).
+ * @param The swiss table.
+ * @param Value to be inserted.
+ */
+void swisstableInsert(swisstable_t *, const int);
+
+/**
+ * @brief Search for a value in the swiss table.
+ * @param The swiss table.
+ * @param Value to be searched.
+ * @return Slot containing such value, if it exists; otherwise, NULL.
+ */
+int *swisstableSearch(swisstable_t *, const int);
+
+/**
+ * @brief Delete value from the swiss table.
+ * @param The swiss table.
+ * @param Slot to be deleted (returned by swisstableSearch).
+ */
+void swisstableDelete(swisstable_t *, int *);
+
+/**
+ * @brief Test swiss table implementation.
+ * @return True if it is correct; otherwise, false.
+ */
+bool swisstableTest();
+
+/**
+ * @brief Free swiss table.
+ * @param Swiss table to be freed.
+ */
+void swisstableFree(swisstable_t *);
+
+// ----- End of SWISS TABLE ----- //
+
 // ----- RBT ----- //
 
 /**
  * @brief Create new RBT node.
+ * @param Pool of the node (NULL: malloc).
  * @param Value that the RBT node should contain.
  * @return Created RBT node.
  */
-rbtNode_t *createRbtNode(const int);
+rbtNode_t *createRbtNode(nodePool_t *, const int);
 
 /**
  * @brief Create new RBT.
+ * @param Are the nodes allocated from a node pool of the RBT?
  * @return Created RBT.
  */
-rbt_t *createRbt();
+rbt_t *createRbt(const bool);
 
 /**
  * @brief Left rotate operation.
@@ -317,6 +756,36 @@ void rbtInsert(rbt_t *, rbtNode_t *);
  */
 void rbtInsertFixup(rbt_t *, rbtNode_t *);
 
+/**
+ * @brief Replace the subtree rooted at a RBT node with the subtree rooted at another one.
+ * @param The RBT.
+ * @param The RBT node to be replaced.
+ * @param The RBT node replacing it (possibly NIL).
+ */
+void rbtTransplant(rbt_t *, rbtNode_t *, rbtNode_t *);
+
+/**
+ * @brief Find the RBT node with the minimum value of a subtree.
+ * @param The RBT.
+ * @param Root of the subtree (not NIL).
+ * @return RBT node with the minimum value.
+ */
+rbtNode_t *rbtMinimum(rbt_t *, rbtNode_t *);
+
+/**
+ * @brief Delete RBT node from the RBT, and free it.
+ * @param The RBT.
+ * @param The RBT node to be deleted.
+ */
+void rbtDelete(rbt_t *, rbtNode_t *);
+
+/**
+ * @brief Fixup function for RBT deletion.
+ * @param The RBT the be fixed.
+ * @param The RBT node carrying the extra black (possibly NIL).
+ */
+void rbtDeleteFixup(rbt_t *, rbtNode_t *);
+
 /**
  * @brief Search for a value in the RBT.
  * @param The RBT.
@@ -325,6 +794,15 @@ void rbtInsertFixup(rbt_t *, rbtNode_t *);
  */
 rbtNode_t *rbtSearch(rbt_t *, const int);
 
+/**
+ * @brief Search for a batch of values in the RBT, interleaving their traversals with prefetches.
+ * @param The RBT.
+ * @param Values to be searched.
+ * @param Number of values.
+ * @param RBT node containing each value, if it exists; otherwise, NIL (output).
+ */
+void rbtSearchBatch(rbt_t *, const int *, const unsigned int, rbtNode_t **);
+
 /**
  * @brief Print RBT in order.
  * @param RBT to be printed.
@@ -364,7 +842,7 @@ void rbtHasBstPropertyUtil(rbt_t *, rbtNode_t *, rbtTestStructure_t *);
  * @brief Function that computes the black height of the RBT.
  * @param The RBT.
  * @param Current RBT node.
- * @return Black height if all paths have the same black height; otherwise, -1.
+ * @return Black height if all paths have the same black height and no red node has a red child; otherwise, -1.
  */
 int rbtComputeBlackHeight(rbt_t *, rbtNode_t *);
 
@@ -383,14 +861,135 @@ void rbtFree(rbt_t *);
 
 // ----- End of RBT ----- //
 
+// ----- B+ TREE ----- //
+
+/**
+ * @brief Create new B+ tree node, with no keys.
+ * @param Is it a leaf?
+ * @return Created B+ tree node.
+ */
+btreeNode_t *createBtreeNode(const bool);
+
+/**
+ * @brief Create new B+ tree.
+ * @return Created B+ tree.
+ */
+btree_t *createBtree();
+
+/**
+ * @brief Count the keys of a B+ tree node less than a value, comparing all of them at once (SSE2, when available).
+ * @param The B+ tree node.
+ * @param The value.
+ * @return Number of keys less than the value.
+ */
+int btreeRank(const btreeNode_t *, const int);
+
+/**
+ * @brief Insert value in the subtree of a B+ tree node, splitting the full nodes on the way back.
+ * @param The B+ tree.
+ * @param Root of the subtree.
+ * @param Value to be inserted.
+ * @param First key of the new right sibling of the node, if it has been split (output).
+ * @param New right sibling of the node, if it has been split (output).
+ * @return True if the node has been split; otherwise, false.
+ */
+bool btreeInsertNode(btree_t *, btreeNode_t *, const int, int *, btreeNode_t **);
+
+/**
+ * @brief Insert value in the B+ tree.
+ * @param The B+ tree.
+ * @param Value to be inserted.
+ */
+void btreeInsert(btree_t *, const int);
+
+/**
+ * @brief Find the first key of the B+ tree not less than a value.
+ * @param The B+ tree.
+ * @param The value.
+ * @param Position of the key in its leaf (output).
+ * @return Leaf containing the key, if it exists; otherwise, NULL.
+ */
+btreeNode_t *btreeLowerBound(btree_t *, const int, int *);
+
+/**
+ * @brief Search for a value in the B+ tree.
+ * @param The B+ tree.
+ * @param Value to be searched.
+ * @return Key equal to the value in its leaf, if it exists; otherwise, NULL.
+ */
+int *btreeSearch(btree_t *, const int);
+
+/**
+ * @brief Refill a child of a B+ tree node with fewer than BTREE_MIN_KEYS keys, from a sibling or by merging them.
+ * @param Parent of the child.
+ * @param Index of the child.
+ */
+void btreeRebalance(btreeNode_t *, const int);
+
+/**
+ * @brief Delete one occurrence of a value from the subtree of a B+ tree node, refilling the children left with too
+ *        few keys on the way back.
+ * @param Root of the subtree.
+ * @param Value to be deleted.
+ * @return True if the value has been found and deleted; otherwise, false.
+ */
+bool btreeDeleteNode(btreeNode_t *, const int);
+
+/**
+ * @brief Delete one occurrence of a value from the B+ tree.
+ * @param The B+ tree.
+ * @param Value to be deleted.
+ * @return True if the value has been found and deleted; otherwise, false.
+ */
+bool btreeDelete(btree_t *, const int);
+
+/**
+ * @brief Check the invariants of the subtree of a B+ tree node.
+ * @param Root of the subtree.
+ * @param Is it the root of the B+ tree?
+ * @param Number of levels of the subtree.
+ * @return True if they hold; otherwise, false.
+ */
+bool btreeIsValid(const btreeNode_t *, const bool, const unsigned int);
+
+/**
+ * @brief Test B+ tree implementation.
+ * @return True if it is correct; otherwise, false.
+ */
+bool btreeTest();
+
+/**
+ * @brief Free B+ tree nodes.
+ * @param Root of the subtree to be freed.
+ */
+void btreeFreeNodes(btreeNode_t *);
+
+/**
+ * @brief Free B+ tree.
+ * @param B+ tree to be freed.
+ */
+void btreeFree(btree_t *);
+
+// ----- End of B+ TREE ----- //
+
 // ----- AUXILIARY FUNCTIONS ----- //
 /**
- * @brief Generate a collection of random numbers.
+ * @brief Generate a collection of random numbers in the interval [1, MAX_RANDOM_NUMBER].
  * @param Array of random numbers.
  * @param Size of the array.
  */
 void generateRandomArray(int *, const int);
 
+/**
+ * @brief Generate the operations of an experiment: the insertions followed by the searches or, if there are
+ *        deletions, all of them in a random order.
+ * @param Operations.
+ * @param Number of insert operations.
+ * @param Number of search operations.
+ * @param Number of delete operations.
+ */
+void generateOperations(operationEnum_t *, const unsigned int, const unsigned int, const unsigned int);
+
 /**
  * @brief Unit test: check if the input array is sorted.
  * @param Array to be checked if sorted.
@@ -399,36 +998,119 @@ void generateRandomArray(int *, const int);
  */
 bool isSorted(const int *, const int);
 
+/**
+ * @brief Print the columns of the hardware performance counters of all the data structures that end a horizontal
+ *        separator of the table (nothing unless MEASURE_COUNTERS).
+ */
+void printCountersSeparator();
+
+/**
+ * @brief Print a hardware performance counter for each operation as a column of the table ("n/a" if it is
+ *        unavailable).
+ * @param Hardware performance counters.
+ * @param Index of the counter (in the order of perfCounterNames).
+ * @param Number of operations.
+ */
+void printCounterPerOperation(const perfValues_t *, const int, const unsigned int);
+
 // ----- End of AUXILIARY FUNCTIONS ----- //
 
 // ----- CORE FUNCTIONS ----- //
 
 /**
  * @brief Function that does the experiment.
- * @param Array of random numbers.
- * @param Number of insertion operations.
- * @param Number of search operations.
+ * @param Array of random keys: PREFILL_KEYS keys inserted before the timed region, then the key of each operation.
+ * @param Operations.
+ * @param Number of operations.
  * @param Data structure to be used. The possible values are:
- * @return Elapsed time for the experiment.
+ * @param Hardware performance counters of the experiment (unavailable unless MEASURE_COUNTERS).
+ * @param Number of searches that found their key (output).
+ * @return Elapsed time for the experiment, in nanoseconds.
+ */
+unsigned long long doExperiment(int *, operationEnum_t *, const unsigned int, char *, perfValues_t *, unsigned int *);
+
+/**
+ * @brief Job of the experiment: all the data structures on the same keys and operations, drawn from the random stream
+ *        of the job.
+ * @param Jobs of a number of operations (operationsJobs_t).
+ * @param Index of the job.
+ */
+void operationsJob(void *, int);
+
+/**
+ * @brief Start of a worker of the runner: open its hardware performance counters, if requested.
+ */
+void operationsJobThreadStart();
+
+/**
+ * @brief End of a worker of the runner: close its hardware performance counters.
+ */
+void operationsJobThreadEnd();
+
+/**
+ * @brief Resize experiment: latency of each insertion into a static hashtable and into hashtables resizing
+ *        incrementally and all at once, then the mean time of a search.
+ * @param Machine-readable output of the statistics of the insert latencies (NULL: none).
+ */
+void resizeExperiment(FILE *);
+
+/**
+ * @brief B+ tree experiment: time and cache misses of a search for an inserted key as the B+ tree and the RBT grow.
+ * @param Machine-readable output of the statistics of the search times (NULL: none).
+ */
+void btreeExperiment(FILE *);
+
+/**
+ * @brief Batch experiment: time of a search for an inserted key one at a time and in batches of 1 to
+ *        SEARCH_BATCH_GROUP keys, in a hashtable and an RBT larger than the caches.
+ * @param Machine-readable output of the statistics of the search times (NULL: none).
  */
-clock_t doExperiment(int *, const unsigned int, const unsigned int, char *);
+void batchExperiment(FILE *);
 
 // ----- End of CORE FUNCTIONS ----- //
 
 // ##### End of PROTOTYPES OF THE FUNCTIONS ##### //
 
-int main()
+int main(int argc, char **argv)
 {
+    // Parameters from the command line and the config file (it exits on --help or on invalid options).
+    optionsParse(argc, argv, options, NUM_OPTIONS);
+    // The options are valid one by one, but the sweep also needs them to be consistent.
+    if (STEP == 0 || MIN_OPERATIONS > MAX_OPERATIONS || NUM_EXPERIMENTS < 1)
+    {
+        fprintf(stderr, "ERROR: The step (%u) and the experiments (%u) must be positive, and the minimum number of operations (%u) at most the maximum (%u)\n",
+                STEP, NUM_EXPERIMENTS, MIN_OPERATIONS, MAX_OPERATIONS);
+        exit(1);
+    }
     // Random seed initialization.
-    srand(RANDOM_SEED);
-    // Elapsed time for hashtable.
-    clock_t timeHashtable = 0;
-    // Elapsed time for RBT.
-    clock_t timeRbt = 0;
-    // Number of insert operations.
-    unsigned int numInsertions = 0;
-    // Number of search operations.
-    unsigned int numSearches = 0;
+    prngSeed(&randomGenerator, RANDOM_SEED, 0);
+    // Elapsed times for hashtable.
+    benchmarkSamples_t timesHashtable;
+    // Elapsed times for RBT.
+    benchmarkSamples_t timesRbt;
+    // Elapsed times for swiss table.
+    benchmarkSamples_t timesSwisstable;
+    // Elapsed times for B+ tree.
+    benchmarkSamples_t timesBtree;
+    // Statistics of the elapsed times.
+    benchmarkStats_t statsHashtable, statsRbt, statsSwisstable, statsBtree;
+    // Machine-readable output.
+    FILE *benchmarkPointer;
+    // Hardware performance counters accumulated over the experiments.
+    perfValues_t countersHashtable, countersRbt, countersSwisstable, countersBtree;
+    // Runs of a number of operations (warmups first).
+    operationsJobs_t jobs;
+    // Runner of the jobs of the experiment.
+    runner_t runner;
+    // Number of runs of a number of operations.
+    const int numJobs = NUM_WARMUP_RUNS + NUM_EXPERIMENTS;
+    // Is it a matrix run (one table for each pair of m and percentage of insertions)?
+    const bool matrix = MATRIX_ENTRIES.size > 0 || MATRIX_INSERTIONS.size > 0;
+    // Single values, when the matrix does not iterate over them.
+    const optionList_t entries = MATRIX_ENTRIES.size > 0 ? MATRIX_ENTRIES : (optionList_t){1, {NUM_ENTRIES}};
+    const optionList_t insertions = MATRIX_INSERTIONS.size > 0 ? MATRIX_INSERTIONS : (optionList_t){1, {PERCENTAGE_INSERTIONS}};
+    // Name of the experiment in the machine-readable output (with m and the percentage of insertions in a matrix run).
+    char experiment[64] = "operations";
 
     // What is the outputPointer?
     if (outputType == ONCONSOLE || outputType == ONFILE)
@@ -454,110 +1136,323 @@ int main()
         exit(-1);
     }
 
-    // Print the header, only if itONFILE is on console.
-    if (outputType == ONCONSOLE)
+    // Pin the experiment to a core, if requested.
+    if (PIN_CORE >= 0 && !benchmarkPinToCore(PIN_CORE))
+        fprintf(stderr, "ERROR: The experiment has not been pinned to core %d\n", PIN_CORE);
+    // Open the machine-readable output, if requested.
+    benchmarkPointer = benchmarkOpen(BENCHMARK_FILE, BENCHMARK_FORMAT);
+    benchmarkSamplesInit(&timesHashtable);
+    benchmarkSamplesInit(&timesRbt);
+    benchmarkSamplesInit(&timesSwisstable);
+    benchmarkSamplesInit(&timesBtree);
+    // Allocate the results of all the runs of a number of operations.
+    jobs.timesHashtable = malloc(numJobs * sizeof(unsigned long long));
+    jobs.timesRbt = malloc(numJobs * sizeof(unsigned long long));
+    jobs.countersHashtable = malloc(numJobs * sizeof(perfValues_t));
+    jobs.countersRbt = malloc(numJobs * sizeof(perfValues_t));
+    jobs.timesSwisstable = malloc(numJobs * sizeof(unsigned long long));
+    jobs.countersSwisstable = malloc(numJobs * sizeof(perfValues_t));
+    jobs.timesBtree = malloc(numJobs * sizeof(unsigned long long));
+    jobs.countersBtree = malloc(numJobs * sizeof(perfValues_t));
+    // Threads of the (number of operations, repetition) jobs, pinned to the allowed (or isolated) cores.
+    runnerInit(&runner, EXPERIMENT_THREADS, ISOLATED_CORES_ONLY, operationsJobThreadStart, operationsJobThreadEnd);
+    // Open the hardware performance counters, if requested (the unavailable ones are shown as n/a).
+    if (MEASURE_COUNTERS)
     {
-        fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+\n");
-        fprintf(outputPointer, "| Operations - %%I & %%S        | Hashtable - %-5d   | Red Black Tree      |\n", NUM_ENTRIES);
-        fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+\n");
+        int available = perfCountersOpen(&perfCounters);
+        if (available < PERF_NUM_COUNTERS)
+            fprintf(stderr, "ERROR: Only %d of %d hardware performance counters are available\n", available, PERF_NUM_COUNTERS);
     }
 
-    // For each number of operations in the interval [MIN_OPERATIONS, MAX_OPERATIONS] with STEP
-    for (int numOps = MIN_OPERATIONS; numOps <= MAX_OPERATIONS; numOps += STEP)
+    // One table for each cell of the matrix, in the same process (the allocator and the caches stay warm).
+    for (int cell = 0; cell < entries.size * insertions.size; cell++)
     {
-        // Reset the times.
-        timeHashtable = timeRbt = 0;
-        // For each experiment
-        for (int exper = 1; exper <= NUM_EXPERIMENTS; exper++)
+        NUM_ENTRIES = entries.values[cell / insertions.size];
+        PERCENTAGE_INSERTIONS = insertions.values[cell % insertions.size];
+        if (PERCENTAGE_INSERTIONS + PERCENTAGE_DELETIONS > 100)
+        {
+            fprintf(stderr, "ERROR: The percentages of insertions (%u) and deletions (%u) exceed 100\n", PERCENTAGE_INSERTIONS, PERCENTAGE_DELETIONS);
+            exit(1);
+        }
+        if (matrix)
+            snprintf(experiment, sizeof(experiment), "operations-m%u-i%u", NUM_ENTRIES, PERCENTAGE_INSERTIONS);
+        // The deletions and the prefill are in the name only when they are used.
+        if (PERCENTAGE_DELETIONS > 0 || PREFILL_KEYS > 0)
+            snprintf(experiment + strlen(experiment), sizeof(experiment) - strlen(experiment), "-d%u-p%u", PERCENTAGE_DELETIONS, PREFILL_KEYS);
+        // The previous table ends here (the last one ends with the legend).
+        if (cell > 0 && outputType == ONCONSOLE)
+        {
+            fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+---------------------+---------------------+");
+            printCountersSeparator();
+            fprintf(outputPointer, "\n\n");
+        }
+
+        // Print the header, only if itONFILE is on console.
+        if (outputType == ONCONSOLE)
         {
+            if (PERCENTAGE_DELETIONS > 0 || PREFILL_KEYS > 0)
+                fprintf(outputPointer, "Deletions: %u%% of the operations, after %u keys inserted (%%S: the rest)\n", PERCENTAGE_DELETIONS, PREFILL_KEYS);
+            fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+---------------------+---------------------+");
+            printCountersSeparator();
+            fprintf(outputPointer, "\n| Operations - %%I & %%S        | Hashtable - %-5d   | Red Black Tree      | Swiss table         | B+ tree             |", NUM_ENTRIES);
+            for (int c = 0; MEASURE_COUNTERS && c < 4 * PERF_NUM_COUNTERS; c++)
+                fprintf(outputPointer, " %-13s |", c == 0 ? "Hashtable" : c == PERF_NUM_COUNTERS ? "RBT" : c == 2 * PERF_NUM_COUNTERS ? "Swiss table" : c == 3 * PERF_NUM_COUNTERS ? "B+ tree" : "");
+            fprintf(outputPointer, "\n|                             | Median time (ns)    | Median time (ns)    | Median time (ns)    | Median time (ns)    |");
+            if (MEASURE_COUNTERS)
+            {
+                perfHeaderPrint(outputPointer, "", " |");
+                perfHeaderPrint(outputPointer, "", " |");
+                perfHeaderPrint(outputPointer, "", " |");
+                perfHeaderPrint(outputPointer, "", " |");
+            }
+            fprintf(outputPointer, "\n+-----------------------------+---------------------+---------------------+---------------------+---------------------+");
+            printCountersSeparator();
+            fprintf(outputPointer, "\n");
+        }
 
+        // For each number of operations in the interval [MIN_OPERATIONS, MAX_OPERATIONS] with STEP
+        for (int numOps = MIN_OPERATIONS; numOps <= MAX_OPERATIONS; numOps += STEP)
+        {
+            // Reset the times.
+            benchmarkSamplesReset(&timesHashtable);
+            benchmarkSamplesReset(&timesRbt);
+            benchmarkSamplesReset(&timesSwisstable);
+            benchmarkSamplesReset(&timesBtree);
+            perfValuesReset(&countersHashtable);
+            perfValuesReset(&countersRbt);
+            perfValuesReset(&countersSwisstable);
+            perfValuesReset(&countersBtree);
             // Compute the number of insert operations.
-            numInsertions = numOps * PERCENTAGE_INSERTIONS / 100;
+            jobs.numInsertions = numOps * PERCENTAGE_INSERTIONS / 100;
+            // Compute the number of delete operations.
+            jobs.numDeletions = numOps * PERCENTAGE_DELETIONS / 100;
             // Compute the number of search operations.
-            numSearches = numOps - numInsertions;
-            // Allocate numInsertions memory cells for the array of random numbers.
-            int *randomArray = malloc(numInsertions * sizeof(int));
-            // Fill-in the array with random numbers.
-            generateRandomArray(randomArray, numInsertions);
-            // Hashtable experiment.
-            timeHashtable += doExperiment(randomArray, numInsertions, numSearches, "hashtable");
-            // RBT experiment.
-            timeRbt += doExperiment(randomArray, numInsertions, numSearches, "rbt");
-            // Free the array of random numbers.
-            free(randomArray);
+            jobs.numSearches = numOps - jobs.numInsertions - jobs.numDeletions;
+            jobs.row = (numOps - MIN_OPERATIONS) / STEP;
+            // Each experiment (after NUM_WARMUP_RUNS untimed ones) is an independent job, and the results are read in
+            // the serial order.
+            runnerRun(&runner, numJobs, operationsJob, &jobs);
+            for (int job = NUM_WARMUP_RUNS; job < numJobs; job++)
+            {
+                benchmarkSamplesAdd(&timesHashtable, jobs.timesHashtable[job]);
+                benchmarkSamplesAdd(&timesRbt, jobs.timesRbt[job]);
+                benchmarkSamplesAdd(&timesSwisstable, jobs.timesSwisstable[job]);
+                benchmarkSamplesAdd(&timesBtree, jobs.timesBtree[job]);
+                perfValuesAdd(&countersHashtable, &jobs.countersHashtable[job]);
+                perfValuesAdd(&countersRbt, &jobs.countersRbt[job]);
+                perfValuesAdd(&countersSwisstable, &jobs.countersSwisstable[job]);
+                perfValuesAdd(&countersBtree, &jobs.countersBtree[job]);
+            }
+            statsHashtable = benchmarkComputeStats(&timesHashtable);
+            statsRbt = benchmarkComputeStats(&timesRbt);
+            statsSwisstable = benchmarkComputeStats(&timesSwisstable);
+            statsBtree = benchmarkComputeStats(&timesBtree);
+            // Printing the (sample median as) result. Use TAB (\t) on file.
+            if (outputType == ONCONSOLE)
+                fprintf(outputPointer, "| %15d - %-3d & %-3d | %19f | %19f | %19f | %19f |",
+                        numOps,
+                        PERCENTAGE_INSERTIONS,
+                        100 - PERCENTAGE_INSERTIONS - PERCENTAGE_DELETIONS,
+                        statsHashtable.median,
+                        statsRbt.median,
+                        statsSwisstable.median,
+                        statsBtree.median);
+            else
+                fprintf(outputPointer, "%d \t%f \t%f \t%f \t%f ",
+                        numOps,
+                        statsHashtable.median,
+                        statsRbt.median,
+                        statsSwisstable.median,
+                        statsBtree.median);
+            // Mean hardware performance counters of an experiment.
+            if (MEASURE_COUNTERS)
+            {
+                perfValuesPrint(outputPointer, &countersHashtable, NUM_EXPERIMENTS, outputType == ONCONSOLE ? "" : "\t", outputType == ONCONSOLE ? " |" : "");
+                perfValuesPrint(outputPointer, &countersRbt, NUM_EXPERIMENTS, outputType == ONCONSOLE ? "" : "\t", outputType == ONCONSOLE ? " |" : "");
+                perfValuesPrint(outputPointer, &countersSwisstable, NUM_EXPERIMENTS, outputType == ONCONSOLE ? "" : "\t", outputType == ONCONSOLE ? " |" : "");
+                perfValuesPrint(outputPointer, &countersBtree, NUM_EXPERIMENTS, outputType == ONCONSOLE ? "" : "\t", outputType == ONCONSOLE ? " |" : "");
+            }
+            fprintf(outputPointer, "\n");
+            // All the statistics go to the machine-readable output.
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, experiment, "hashtable", numOps, &statsHashtable);
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, experiment, "rbt", numOps, &statsRbt);
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, experiment, "swisstable", numOps, &statsSwisstable);
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, experiment, "btree", numOps, &statsBtree);
         }
-        // Printing the (sample mean as) result. Use TAB (\t) on file.
-        if (outputType == ONCONSOLE)
-            fprintf(outputPointer, "| %15d - %-3d & %-3d | %19f | %19f |\n",
-                    numOps,
-                    PERCENTAGE_INSERTIONS,
-                    100 - PERCENTAGE_INSERTIONS,
-                    (float)timeHashtable / NUM_EXPERIMENTS,
-                    (float)timeRbt / NUM_EXPERIMENTS);
-        else
-            fprintf(outputPointer, "%d \t%f \t%f \n",
-                    numOps,
-                    (float)timeHashtable / NUM_EXPERIMENTS,
-                    (float)timeRbt / NUM_EXPERIMENTS);
     }
+    benchmarkSamplesFree(&timesHashtable);
+    benchmarkSamplesFree(&timesRbt);
+    benchmarkSamplesFree(&timesSwisstable);
+    benchmarkSamplesFree(&timesBtree);
+    free(jobs.timesHashtable);
+    free(jobs.timesRbt);
+    free(jobs.timesSwisstable);
+    free(jobs.countersHashtable);
+    free(jobs.countersRbt);
+    free(jobs.countersSwisstable);
+    free(jobs.timesBtree);
+    free(jobs.countersBtree);
+    perfCountersClose(&perfCounters);
 
     // Print the ending part, only if it is on console.
     if (outputType == ONCONSOLE)
     {
-        fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+\n");
+        fprintf(outputPointer, "+-----------------------------+---------------------+---------------------+---------------------+---------------------+");
+        printCountersSeparator();
+        fprintf(outputPointer, "\n");
         fprintf(outputPointer, "| Legend:                                                                 |\n");
         fprintf(outputPointer, "|                                                                         |\n");
         fprintf(outputPointer, "| %%I: Percentage of insertion operations                                  |\n");
         fprintf(outputPointer, "| %%S: Percentage of search operations                                     |\n");
         fprintf(outputPointer, "|                                                                         |\n");
         fprintf(outputPointer, "| The number near \"Hashtable\" is the number of entries in the hashtable   |\n");
+        fprintf(outputPointer, "| The swiss table starts with as many slots (rounded up to 16)            |\n");
+        fprintf(outputPointer, "| The B+ tree has up to %-2d keys in each node                              |\n", BTREE_KEYS);
         fprintf(outputPointer, "+-------------------------------------------------------------------------+\n");
     }
     if (TEST_DATA_STRUCTURES)
     {
         fprintf(outputPointer, "| Hashtable implementation: %-12s                                  |\n", hashtableTest() ? "correct" : "not correct");
         fprintf(outputPointer, "| Red black tree implementation: %-12s                             |\n", rbtTest() ? "correct" : "not correct");
+        fprintf(outputPointer, "| Swiss table implementation: %-12s                                |\n", swisstableTest() ? "correct" : "not correct");
+        fprintf(outputPointer, "| B+ tree implementation: %-12s                                    |\n", btreeTest() ? "correct" : "not correct");
         fprintf(outputPointer, "+-------------------------------------------------------------------------+\n");
     }
+    // Insert latencies of the static hashtable against the resizable ones.
+    if (RUN_RESIZE_EXPERIMENT)
+        resizeExperiment(benchmarkPointer);
+    // Search times and cache misses of the B+ tree against the RBT, beyond the size of the caches.
+    if (RUN_BTREE_EXPERIMENT)
+        btreeExperiment(benchmarkPointer);
+    // Search times one at a time against batches of interleaved searches.
+    if (RUN_BATCH_EXPERIMENT)
+        batchExperiment(benchmarkPointer);
+    benchmarkClose(benchmarkPointer);
     return 0;
 }
 
 // ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
 
-// ----- LINKED LIST ----- //
+// ----- NODE POOL ----- //
 
 /**
- * @brief Create a new linked list node.
- * @param v Value that the linked list node should contain.
- * @return Created linked list node.
+ * @brief Create a new node pool.
+ * @param nodeSize Size of a node.
+ * @return Created node pool.
  */
-linkedListNode_t *createLinkedListNode(const int v)
+nodePool_t *createNodePool(const size_t nodeSize)
 {
-    linkedListNode_t *node = malloc(sizeof(linkedListNode_t));
-    node->value = v;
-    node->next = NULL;
-    node->prev = NULL;
+    nodePool_t *pool = malloc(sizeof(nodePool_t));
+    if (!pool)
+        return NULL;
+    // Rounded up to a multiple of a pointer, so that every node is aligned like its fields.
+    pool->nodeSize = (nodeSize + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    pool->freeList = NULL;
+    pool->next = NULL;
+    pool->end = NULL;
+    pool->chunkNodes = NODE_POOL_FIRST_CHUNK_NODES;
+    pool->chunks = NULL;
+    return pool;
+}
+
+/**
+ * @brief Allocate a node from the node pool: a released one if any, otherwise the next one of the current chunk.
+ * @param pool The node pool.
+ * @return Allocated node.
+ */
+void *nodePoolAlloc(nodePool_t *pool)
+{
+    void *node = pool->freeList;
+    void **chunk;
+    if (node != NULL)
+    {
+        pool->freeList = *(void **)node;
+        return node;
+    }
+    if (pool->next == pool->end)
+    {
+        // A new chunk, after the pointer to the previous one (padded to keep the nodes aligned).
+        chunk = malloc(sizeof(max_align_t) + pool->chunkNodes * pool->nodeSize);
+        if (!chunk)
+            return NULL;
+        *chunk = pool->chunks;
+        pool->chunks = chunk;
+        pool->next = (char *)chunk + sizeof(max_align_t);
+        pool->end = pool->next + pool->chunkNodes * pool->nodeSize;
+        if (pool->chunkNodes < NODE_POOL_MAX_CHUNK_NODES)
+            pool->chunkNodes *= 2;
+    }
+    node = pool->next;
+    pool->next += pool->nodeSize;
     return node;
 }
 
 /**
- * @brief Create a new linked list.
- * @return Created linked list.
+ * @brief Release a node to the node pool.
+ * @param pool The node pool.
+ * @param x Node to be released.
  */
-linkedList_t *createLinkedList()
+void nodePoolFree(nodePool_t *pool, void *x)
 {
-    linkedList_t *list = malloc(sizeof(linkedList_t));
-    list->size = 0;
-    list->head = NULL;
-    return list;
+    *(void **)x = pool->freeList;
+    pool->freeList = x;
 }
 
 /**
- * @brief Insert linked list node in the head of the linked list.
- * @param list The linked list.
- * @param x Linked list node to be inserted.
+ * @brief Free the node pool with all its nodes at once.
+ * @param pool Node pool to be freed.
  */
-void linkedListInsert(linkedList_t *list, linkedListNode_t *x)
+void nodePoolRelease(nodePool_t *pool)
+{
+    void **chunk;
+    while (pool->chunks != NULL)
+    {
+        chunk = pool->chunks;
+        pool->chunks = *chunk;
+        free(chunk);
+    }
+    free(pool);
+}
+
+// ----- End of NODE POOL ----- //
+
+// ----- LINKED LIST ----- //
+
+/**
+ * @brief Create a new linked list node.
+ * @param pool Pool of the node (NULL: malloc).
+ * @param v Value that the linked list node should contain.
+ * @return Created linked list node.
+ */
+linkedListNode_t *createLinkedListNode(nodePool_t *pool, const int v)
+{
+    linkedListNode_t *node = pool != NULL ? nodePoolAlloc(pool) : malloc(sizeof(linkedListNode_t));
+    node->value = v;
+    node->next = NULL;
+    node->prev = NULL;
+    return node;
+}
+
+/**
+ * @brief Create a new linked list.
+ * @param pool Pool of the nodes (NULL: malloc).
+ * @return Created linked list.
+ */
+linkedList_t *createLinkedList(nodePool_t *pool)
+{
+    linkedList_t *list = malloc(sizeof(linkedList_t));
+    list->size = 0;
+    list->head = NULL;
+    list->pool = pool;
+    return list;
+}
+
+/**
+ * @brief Insert linked list node in the head of the linked list.
+ * @param list The linked list.
+ * @param x Linked list node to be inserted.
+ */
+void linkedListInsert(linkedList_t *list, linkedListNode_t *x)
 {
     x->next = list->head;
     if (list->head != NULL)
@@ -596,7 +1491,10 @@ void linkedListDelete(linkedList_t *list, linkedListNode_t *x)
     if (x->next != NULL)
         x->next->prev = x->prev;
     list->size = list->size - 1;
-    free(x);
+    if (list->pool != NULL)
+        nodePoolFree(list->pool, x);
+    else
+        free(x);
 }
 
 /**
@@ -620,7 +1518,8 @@ void linkedListPrint(linkedList_t *list)
 void linkedListFree(linkedList_t *list)
 {
     linkedListNode_t *nodo;
-    while (list->head != NULL)
+    // The nodes of a pool are freed with the pool.
+    while (list->pool == NULL && list->head != NULL)
     {
         nodo = list->head;
         list->head = list->head->next;
@@ -636,9 +1535,11 @@ void linkedListFree(linkedList_t *list)
 /**
  * @brief Create a new hashtable.
  * @param s The size of the hashtable (i.e., the number of entries).
+ * @param resizable Does it resize itself with its load factor (from the given size)?
+ * @param pooled Are the nodes allocated from a node pool of the hashtable?
  * @return The created hashtable.
  */
-hashtable_t *createHashtable(const unsigned int s)
+hashtable_t *createHashtable(const unsigned int s, const bool resizable, const bool pooled)
 {
     hashtable_t *hash = malloc(sizeof(hashtable_t));
     hashtableEntry_t *head; //Linkedlist
@@ -648,12 +1549,19 @@ hashtable_t *createHashtable(const unsigned int s)
     if (!hash->entry)
         return NULL;
     hash->size = s;
-    for (int i = 0; i < hash->size; i++)
+    hash->count = 0;
+    hash->resizable = resizable;
+    hash->minSize = s;
+    hash->oldSize = 0;
+    hash->oldEntry = NULL;
+    hash->migrated = 0;
+    hash->pool = pooled ? createNodePool(sizeof(linkedListNode_t)) : NULL;
+    for (unsigned int i = 0; i < hash->size; i++)
     {
         head = malloc(sizeof(hashtableEntry_t));
         if (!head)
             return NULL;
-        head->list = createLinkedList();
+        head->list = createLinkedList(hash->pool);
         hash->entry[i] = head;
     }
     return hash;
@@ -670,6 +1578,86 @@ const unsigned int hashFunction(hashtable_t *hashtbl, const int v)
     return v % hashtbl->size;
 }
 
+/**
+ * @brief Find the pointer to the entry of a value: while resizing, it is in the old entries until its old entry has
+ *        been moved.
+ * @param hashtbl The hashtable.
+ * @param v The value.
+ * @return Address of the pointer to the entry that contains (or would contain) the value.
+ */
+hashtableEntry_t **hashtableSlot(hashtable_t *hashtbl, const int v)
+{
+    if (hashtbl->oldEntry != NULL && v % hashtbl->oldSize >= hashtbl->migrated)
+        return &hashtbl->oldEntry[v % hashtbl->oldSize];
+    return &hashtbl->entry[hashFunction(hashtbl, v)];
+}
+
+/**
+ * @brief Find the list of a value: while resizing, it is in the old entries until its old entry has been moved.
+ * @param hashtbl The hashtable.
+ * @param v The value.
+ * @return The list that contains (or would contain) the value.
+ */
+linkedList_t *hashtableBucket(hashtable_t *hashtbl, const int v)
+{
+    return (*hashtableSlot(hashtbl, v))->list;
+}
+
+/**
+ * @brief Start resizing the hashtable: the values are moved by the next operations (see hashtableRehashStep), so
+ *        that no operation pays for all of them.
+ * @param hashtbl The hashtable.
+ * @param s New size of the hashtable (double or half of the current one).
+ */
+void hashtableResize(hashtable_t *hashtbl, const unsigned int s)
+{
+    // The new entries are created only when the old entries feeding them are moved.
+    hashtableEntry_t **entry = malloc(sizeof(hashtableEntry_t *) * s);
+    if (!entry)
+        return;
+    hashtbl->oldEntry = hashtbl->entry;
+    hashtbl->oldSize = hashtbl->size;
+    hashtbl->entry = entry;
+    hashtbl->size = s;
+    hashtbl->migrated = 0;
+}
+
+/**
+ * @brief Move HASHTABLE_REHASH_STEP old entries (all of them if 0) of a resizing hashtable to the new entries.
+ * @param hashtbl The hashtable.
+ */
+void hashtableRehashStep(hashtable_t *hashtbl)
+{
+    hashtableEntry_t *old;
+    linkedListNode_t *node;
+    unsigned int moved = 0;
+    while (hashtbl->oldEntry != NULL && (HASHTABLE_REHASH_STEP == 0 || moved++ < HASHTABLE_REHASH_STEP))
+    {
+        // Old entry i feeds only the new entries j = i (mod the old size) when doubling, and j = i when halving (the
+        // new entry is created by the first of its two old entries).
+        for (unsigned int j = hashtbl->migrated; j < hashtbl->size; j += hashtbl->oldSize)
+        {
+            hashtbl->entry[j] = malloc(sizeof(hashtableEntry_t));
+            hashtbl->entry[j]->list = createLinkedList(hashtbl->pool);
+        }
+        // The nodes are relinked, not copied: the pointers returned by hashtableSearch stay valid.
+        old = hashtbl->oldEntry[hashtbl->migrated];
+        while ((node = old->list->head) != NULL)
+        {
+            old->list->head = node->next;
+            linkedListInsert(hashtbl->entry[hashFunction(hashtbl, node->value)]->list, node);
+        }
+        free(old->list);
+        free(old);
+        if (++hashtbl->migrated == hashtbl->oldSize)
+        {
+            free(hashtbl->oldEntry);
+            hashtbl->oldEntry = NULL;
+            hashtbl->oldSize = 0;
+        }
+    }
+}
+
 /**
  * @brief Insert value in the hashtable.
  * @param hashtbl The hashtable.
@@ -677,9 +1665,12 @@ const unsigned int hashFunction(hashtable_t *hashtbl, const int v)
  */
 void hashtableInsert(hashtable_t *hashtbl, const int v)
 {
-    int hash = hashFunction(hashtbl, v);
-    linkedListNode_t *node = createLinkedListNode(v);
-    linkedListInsert(hashtbl->entry[hash]->list, node);
+    linkedListNode_t *node = createLinkedListNode(hashtbl->pool, v);
+    hashtableRehashStep(hashtbl);
+    linkedListInsert(hashtableBucket(hashtbl, v), node);
+    hashtbl->count++;
+    if (hashtbl->resizable && hashtbl->oldEntry == NULL && hashtbl->count > HASHTABLE_MAX_LOAD * hashtbl->size)
+        hashtableResize(hashtbl, 2 * hashtbl->size);
 }
 
 /**
@@ -690,8 +1681,65 @@ void hashtableInsert(hashtable_t *hashtbl, const int v)
  */
 linkedListNode_t *hashtableSearch(hashtable_t *hashtbl, const int v)
 {
-    int hash = hashFunction(hashtbl, v);
-    return linkedListSearch(hashtbl->entry[hash]->list, v);
+    hashtableRehashStep(hashtbl);
+    return linkedListSearch(hashtableBucket(hashtbl, v), v);
+}
+
+/**
+ * @brief Search for a batch of values in the hashtable (the same results as hashtableSearch on each of them). The
+ *        searches of a group of up to SEARCH_BATCH_GROUP values go through each step together (group prefetching):
+ *        the pointer to the entry, the entry, the list, then one node of each chain at a time, and every step
+ *        prefetches what the next one reads, so that the cache misses of the group are in flight at once instead of
+ *        one after the other.
+ * @param hashtbl The hashtable.
+ * @param values Values to be searched.
+ * @param n Number of values.
+ * @param results Linked list node containing each value, if it exists; otherwise, NULL (output).
+ */
+void hashtableSearchBatch(hashtable_t *hashtbl, const int *values, const unsigned int n, linkedListNode_t **results)
+{
+    hashtableEntry_t **slots[SEARCH_BATCH_GROUP];
+    unsigned int pending[SEARCH_BATCH_GROUP], numPending, size, i, j, k;
+    linkedListNode_t *node;
+    // A resize moves on as much as with n searches one at a time; the entries do not change during the batch.
+    for (i = 0; i < n; i++)
+        hashtableRehashStep(hashtbl);
+    for (i = 0; i < n; i += SEARCH_BATCH_GROUP)
+    {
+        size = n - i < SEARCH_BATCH_GROUP ? n - i : SEARCH_BATCH_GROUP;
+        for (j = 0; j < size; j++)
+        {
+            slots[j] = hashtableSlot(hashtbl, values[i + j]);
+            __builtin_prefetch(slots[j]);
+        }
+        for (j = 0; j < size; j++)
+            __builtin_prefetch(*slots[j]);
+        for (j = 0; j < size; j++)
+            __builtin_prefetch((*slots[j])->list);
+        for (j = 0; j < size; j++)
+        {
+            results[i + j] = (*slots[j])->list->head;
+            __builtin_prefetch(results[i + j]);
+            pending[j] = i + j;
+        }
+        // Each pass moves every pending search one node down its chain; a search that ends leaves its place to the
+        // last pending one.
+        numPending = size;
+        while (numPending > 0)
+            for (k = 0; k < numPending;)
+            {
+                j = pending[k];
+                node = results[j];
+                if (node == NULL || node->value == values[j])
+                    pending[k] = pending[--numPending];
+                else
+                {
+                    results[j] = node->next;
+                    __builtin_prefetch(results[j]);
+                    k++;
+                }
+            }
+    }
 }
 
 /**
@@ -701,8 +1749,12 @@ linkedListNode_t *hashtableSearch(hashtable_t *hashtbl, const int v)
  */
 void hashtableDelete(hashtable_t *hashtbl, linkedListNode_t *x)
 {
-    int hash = hashFunction(hashtbl, x->value);
-    linkedListDelete(hashtbl->entry[hash]->list, x);
+    hashtableRehashStep(hashtbl);
+    linkedListDelete(hashtableBucket(hashtbl, x->value), x);
+    hashtbl->count--;
+    if (hashtbl->resizable && hashtbl->oldEntry == NULL && hashtbl->size / 2 >= hashtbl->minSize &&
+        hashtbl->count < HASHTABLE_MIN_LOAD * hashtbl->size)
+        hashtableResize(hashtbl, hashtbl->size / 2);
 }
 
 /**
@@ -711,9 +1763,12 @@ void hashtableDelete(hashtable_t *hashtbl, linkedListNode_t *x)
  */
 void hashtablePrint(hashtable_t *hashtbl)
 {
-    for (int i = 0; i < hashtbl->size; i++)
+    // Finish resizing, so that all the values are in the entries.
+    while (hashtbl->oldEntry != NULL)
+        hashtableRehashStep(hashtbl);
+    for (unsigned int i = 0; i < hashtbl->size; i++)
     {
-        fprintf(stdout, "%d => ", i);
+        fprintf(stdout, "%u => ", i);
         linkedListPrint(hashtbl->entry[i]->list);
         fprintf(stdout, "\n");
     }
@@ -725,22 +1780,34 @@ void hashtablePrint(hashtable_t *hashtbl)
  */
 bool hashtableTest()
 {
-    bool test;
+    bool test = true, resized = true;
     int A[NUM_ELEMENTS_FOR_TEST];
-    hashtable_t *hashtbl = createHashtable(NUM_ELEMENTS_FOR_TEST);
+    hashtable_t *hashtbl = createHashtable(NUM_ELEMENTS_FOR_TEST, false, false);
     linkedListNode_t *nodo;
-    for (int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
     {
         A[i] = 0;
         hashtableInsert(hashtbl, A[i]);
         nodo = hashtableSearch(hashtbl, A[i]);
-        if (nodo->value == A[i])
-            test = true;
-        else
-            test = false;
+        test = test && nodo != NULL && nodo->value == A[i];
     }
     hashtableFree(hashtbl);
-    return test;
+    // A resizable hashtable from one entry, with a node pool: the values must be found while it grows and while it
+    // shrinks back.
+    hashtbl = createHashtable(1, true, true);
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+    {
+        hashtableInsert(hashtbl, i + 1);
+        resized = resized && hashtableSearch(hashtbl, i + 1) != NULL && hashtableSearch(hashtbl, i / 2 + 1) != NULL;
+    }
+    for (unsigned int i = 0; i + 1 < NUM_ELEMENTS_FOR_TEST; i++)
+    {
+        hashtableDelete(hashtbl, hashtableSearch(hashtbl, i + 1));
+        resized = resized && hashtableSearch(hashtbl, i + 1) == NULL && hashtableSearch(hashtbl, NUM_ELEMENTS_FOR_TEST) != NULL;
+    }
+    resized = resized && hashtbl->count == 1;
+    hashtableFree(hashtbl);
+    return test && resized;
 }
 
 /**
@@ -749,27 +1816,246 @@ bool hashtableTest()
  */
 void hashtableFree(hashtable_t *hashtbl)
 {
-    for (int i = 0; i < hashtbl->size; i++)
+    for (unsigned int i = 0; i < hashtbl->size; i++)
+        // While resizing, only the new entries fed by the moved old entries exist.
+        if (hashtbl->oldEntry == NULL || i % hashtbl->oldSize < hashtbl->migrated)
+        {
+            linkedListFree(hashtbl->entry[i]->list);
+            free(hashtbl->entry[i]);
+        }
+    for (unsigned int i = hashtbl->migrated; hashtbl->oldEntry != NULL && i < hashtbl->oldSize; i++)
     {
-        linkedListFree(hashtbl->entry[i]->list);
-        free(hashtbl->entry[i]);
+        linkedListFree(hashtbl->oldEntry[i]->list);
+        free(hashtbl->oldEntry[i]);
     }
+    free(hashtbl->oldEntry);
     free(hashtbl->entry);
+    if (hashtbl->pool != NULL)
+        nodePoolRelease(hashtbl->pool);
     free(hashtbl);
 }
 
 // ----- End of HASHTABLE ----- //
 
+// ----- SWISS TABLE ----- //
+
+/**
+ * @brief Create a new swiss table.
+ * @param s Minimum size of the swiss table (i.e., the number of slots), rounded up to a multiple of SWISSTABLE_GROUP.
+ * @return The created swiss table.
+ */
+swisstable_t *createSwisstable(const unsigned int s)
+{
+    swisstable_t *table = malloc(sizeof(swisstable_t));
+    if (!table)
+        return NULL;
+    table->numGroups = s > SWISSTABLE_GROUP ? (s + SWISSTABLE_GROUP - 1) / SWISSTABLE_GROUP : 1;
+    table->capacity = table->numGroups * SWISSTABLE_GROUP;
+    table->size = 0;
+    table->tombstones = 0;
+    // The control bytes of a group are read with one aligned load.
+    table->control = aligned_alloc(SWISSTABLE_GROUP, table->capacity);
+    table->keys = malloc(table->capacity * sizeof(int));
+    if (!table->control || !table->keys)
+        return NULL;
+    memset(table->control, SWISSTABLE_EMPTY, table->capacity);
+    return table;
+}
+
+/**
+ * @brief Hash function computing the 64-bit hash of a given integer (multiplicative).
+ * @param v The integer for which the hash must be computed.
+ * @return The computed hash: the high 32 bits choose the first group, the low 7 bits are the control byte.
+ */
+uint64_t swisstableHash(const int v)
+{
+    uint64_t h = (uint32_t)v * 0x9e3779b97f4a7c15ull;
+    // The low bits of the product depend only on the low bits of v: fold the high ones into them.
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief Find the slots of a group whose control byte is a given one (SSE2, when available).
+ * @param group Control bytes of the group.
+ * @param c Control byte to be found.
+ * @return Bit mask of the slots of the group with such control byte.
+ */
+unsigned int swisstableMatch(const int8_t *group, const int8_t c)
+{
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)group), _mm_set1_epi8(c)));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < SWISSTABLE_GROUP; i++)
+        mask |= (unsigned int)(group[i] == c) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Find the slots of a group that are empty or deleted (i.e., whose control byte has the high bit set).
+ * @param group Control bytes of the group.
+ * @return Bit mask of such slots of the group.
+ */
+unsigned int swisstableMatchFree(const int8_t *group)
+{
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_load_si128((const __m128i *)group));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < SWISSTABLE_GROUP; i++)
+        mask |= (unsigned int)(group[i] < 0) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Rebuild the swiss table with a number of groups, dropping the tombstones.
+ * @param table The swiss table.
+ * @param numGroups New number of groups.
+ */
+void swisstableRehash(swisstable_t *table, const unsigned int numGroups)
+{
+    swisstable_t *rebuilt = createSwisstable(numGroups * SWISSTABLE_GROUP);
+    for (unsigned int i = 0; i < table->capacity; i++)
+        if (table->control[i] >= 0)
+            swisstableInsert(rebuilt, table->keys[i]);
+    free(table->control);
+    free(table->keys);
+    *table = *rebuilt;
+    free(rebuilt);
+}
+
+/**
+ * @brief Insert value in the swiss table (like hashtableInsert, duplicates are kept).
+ * @param table The swiss table.
+ * @param v Value to be inserted.
+ */
+void swisstableInsert(swisstable_t *table, const int v)
+{
+    uint64_t hash = swisstableHash(v);
+    unsigned int g, i, match;
+    // Keys and tombstones fill at most 7/8 of the slots: the table doubles if the keys alone would fill more than
+    // 7/16 of them, otherwise it only drops the tombstones.
+    if ((table->size + table->tombstones + 1) * 8 > table->capacity * 7)
+        swisstableRehash(table, (table->size + 1) * 16 > table->capacity * 7 ? 2 * table->numGroups : table->numGroups);
+    // The first group with an empty or deleted slot, starting from the group of the hash (linear probing on groups).
+    g = ((hash >> 32) * table->numGroups) >> 32;
+    while (!(match = swisstableMatchFree(table->control + g * SWISSTABLE_GROUP)))
+        if (++g == table->numGroups)
+            g = 0;
+    i = g * SWISSTABLE_GROUP + __builtin_ctz(match);
+    if (table->control[i] == SWISSTABLE_DELETED)
+        table->tombstones--;
+    table->control[i] = hash & 0x7F;
+    table->keys[i] = v;
+    table->size++;
+}
+
+/**
+ * @brief Search for a value in the swiss table.
+ * @param table The swiss table.
+ * @param v Value to be searched.
+ * @return Slot containing such value, if it exists; otherwise, NULL.
+ */
+int *swisstableSearch(swisstable_t *table, const int v)
+{
+    uint64_t hash = swisstableHash(v);
+    unsigned int g = ((hash >> 32) * table->numGroups) >> 32, match;
+    const int8_t *group;
+    for (unsigned int probes = 0; probes < table->numGroups; probes++)
+    {
+        group = table->control + g * SWISSTABLE_GROUP;
+        // Only the keys whose control byte matches are compared.
+        for (match = swisstableMatch(group, hash & 0x7F); match; match &= match - 1)
+            if (table->keys[g * SWISSTABLE_GROUP + __builtin_ctz(match)] == v)
+                return &table->keys[g * SWISSTABLE_GROUP + __builtin_ctz(match)];
+        // An empty slot ends the probe sequence: the value would have been inserted there.
+        if (swisstableMatch(group, SWISSTABLE_EMPTY))
+            return NULL;
+        if (++g == table->numGroups)
+            g = 0;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Delete value from the swiss table.
+ * @param table The swiss table.
+ * @param x Slot to be deleted (returned by swisstableSearch).
+ */
+void swisstableDelete(swisstable_t *table, int *x)
+{
+    unsigned int i = x - table->keys;
+    // A group with an empty slot has never been full, so no probe sequence has ever gone past it: the slot can be
+    // empty again. Otherwise it becomes a tombstone, since some keys may be found only by going on to the next groups.
+    if (swisstableMatch(table->control + i / SWISSTABLE_GROUP * SWISSTABLE_GROUP, SWISSTABLE_EMPTY))
+        table->control[i] = SWISSTABLE_EMPTY;
+    else
+    {
+        table->control[i] = SWISSTABLE_DELETED;
+        table->tombstones++;
+    }
+    table->size--;
+}
+
+/**
+ * @brief Test swiss table if it is correctly implemented: distinct keys are inserted (growing the table from one
+ *        group), half of them are deleted and inserted again.
+ * @return True if it is correct; otherwise, false.
+ */
+bool swisstableTest()
+{
+    bool test = true;
+    swisstable_t *table = createSwisstable(1);
+    int *slot;
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+        swisstableInsert(table, (int)i * 7919 + 1);
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+    {
+        slot = swisstableSearch(table, (int)i * 7919 + 1);
+        if (slot == NULL || *slot != (int)i * 7919 + 1)
+            test = false;
+    }
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i += 2)
+        swisstableDelete(table, swisstableSearch(table, (int)i * 7919 + 1));
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+        if ((swisstableSearch(table, (int)i * 7919 + 1) != NULL) != (i % 2 == 1))
+            test = false;
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i += 2)
+        swisstableInsert(table, (int)i * 7919 + 1);
+    for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+        if (swisstableSearch(table, (int)i * 7919 + 1) == NULL)
+            test = false;
+    test = test && table->size == NUM_ELEMENTS_FOR_TEST;
+    swisstableFree(table);
+    return test;
+}
+
+/**
+ * @brief Free swiss table.
+ * @param table Swiss table to be freed.
+ */
+void swisstableFree(swisstable_t *table)
+{
+    free(table->control);
+    free(table->keys);
+    free(table);
+}
+
+// ----- End of SWISS TABLE ----- //
+
 // ----- RBT ----- //
 
 /**
  * @brief Create new RBT node.
+ * @param pool Pool of the node (NULL: malloc).
  * @param v Value that the RBT node should contain.
  * @return Created RBT node.
  */
-rbtNode_t *createRbtNode(const int v)
+rbtNode_t *createRbtNode(nodePool_t *pool, const int v)
 {
-    rbtNode_t *nodo = malloc(sizeof(rbtNode_t));
+    rbtNode_t *nodo = pool != NULL ? nodePoolAlloc(pool) : malloc(sizeof(rbtNode_t));
     nodo->left = NULL;
     nodo->right = NULL;
     nodo->parent = NULL;
@@ -780,13 +2066,15 @@ rbtNode_t *createRbtNode(const int v)
 
 /**
  * @brief Create new RBT.
+ * @param pooled Are the nodes allocated from a node pool of the RBT?
  * @return Created RBT.
  */
-rbt_t *createRbt()
+rbt_t *createRbt(const bool pooled)
 {
     rbt_t *rbt = malloc(sizeof(rbt_t));
     rbt->size = 0;
-    rbt->nil = createRbtNode(0);
+    rbt->pool = pooled ? createNodePool(sizeof(rbtNode_t)) : NULL;
+    rbt->nil = createRbtNode(NULL, 0);
     rbt->nil->color = 'B';
     rbt->root = rbt->nil;
     return rbt;
@@ -933,6 +2221,160 @@ void rbtInsertFixup(rbt_t *rbt, rbtNode_t *z)
     rbt->root->color = 'B';
 }
 
+/**
+ * @brief Replace the subtree rooted at a RBT node with the subtree rooted at another one.
+ * @param rbt The RBT.
+ * @param u The RBT node to be replaced.
+ * @param v The RBT node replacing it (possibly NIL, whose parent is set anyway).
+ */
+void rbtTransplant(rbt_t *rbt, rbtNode_t *u, rbtNode_t *v)
+{
+    if (u->parent == rbt->nil)
+        rbt->root = v;
+    else if (u == u->parent->left)
+        u->parent->left = v;
+    else
+        u->parent->right = v;
+    v->parent = u->parent;
+}
+
+/**
+ * @brief Find the RBT node with the minimum value of a subtree.
+ * @param rbt The RBT.
+ * @param x Root of the subtree (not NIL).
+ * @return RBT node with the minimum value.
+ */
+rbtNode_t *rbtMinimum(rbt_t *rbt, rbtNode_t *x)
+{
+    while (x->left != rbt->nil)
+        x = x->left;
+    return x;
+}
+
+/**
+ * @brief Delete RBT node from the RBT, and free it.
+ * @param rbt The RBT.
+ * @param z The RBT node to be deleted.
+ */
+void rbtDelete(rbt_t *rbt, rbtNode_t *z)
+{
+    rbtNode_t *x, *y = z;
+    char yOriginalColor = y->color;
+    if (z->left == rbt->nil)
+    {
+        x = z->right;
+        rbtTransplant(rbt, z, z->right);
+    }
+    else if (z->right == rbt->nil)
+    {
+        x = z->left;
+        rbtTransplant(rbt, z, z->left);
+    }
+    else
+    {
+        // Two children: the successor y takes the place (and the color) of z.
+        y = rbtMinimum(rbt, z->right);
+        yOriginalColor = y->color;
+        x = y->right;
+        if (y->parent == z)
+            x->parent = y;
+        else
+        {
+            rbtTransplant(rbt, y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+        rbtTransplant(rbt, z, y);
+        y->left = z->left;
+        y->left->parent = y;
+        y->color = z->color;
+    }
+    rbt->size--;
+    // Removing a black node leaves a path with one black node less: x carries the extra black.
+    if (yOriginalColor == 'B')
+        rbtDeleteFixup(rbt, x);
+    if (rbt->pool != NULL)
+        nodePoolFree(rbt->pool, z);
+    else
+        free(z);
+}
+
+/**
+ * @brief Fixup function for RBT deletion.
+ * @param rbt The RBT the be fixed.
+ * @param x The RBT node carrying the extra black (possibly NIL).
+ */
+void rbtDeleteFixup(rbt_t *rbt, rbtNode_t *x)
+{
+    rbtNode_t *w;
+    while (x != rbt->root && x->color == 'B')
+    {
+        if (x == x->parent->left)
+        {
+            w = x->parent->right;
+            if (w->color == 'R')
+            {
+                w->color = 'B';
+                x->parent->color = 'R';
+                rbtLeftRotate(rbt, x->parent);
+                w = x->parent->right;
+            }
+            if (w->left->color == 'B' && w->right->color == 'B')
+            {
+                w->color = 'R';
+                x = x->parent;
+            }
+            else
+            {
+                if (w->right->color == 'B')
+                {
+                    w->left->color = 'B';
+                    w->color = 'R';
+                    rbtRightRotate(rbt, w);
+                    w = x->parent->right;
+                }
+                w->color = x->parent->color;
+                x->parent->color = 'B';
+                w->right->color = 'B';
+                rbtLeftRotate(rbt, x->parent);
+                x = rbt->root;
+            }
+        }
+        else
+        {
+            w = x->parent->left;
+            if (w->color == 'R')
+            {
+                w->color = 'B';
+                x->parent->color = 'R';
+                rbtRightRotate(rbt, x->parent);
+                w = x->parent->left;
+            }
+            if (w->right->color == 'B' && w->left->color == 'B')
+            {
+                w->color = 'R';
+                x = x->parent;
+            }
+            else
+            {
+                if (w->left->color == 'B')
+                {
+                    w->right->color = 'B';
+                    w->color = 'R';
+                    rbtLeftRotate(rbt, w);
+                    w = x->parent->left;
+                }
+                w->color = x->parent->color;
+                x->parent->color = 'B';
+                w->left->color = 'B';
+                rbtRightRotate(rbt, x->parent);
+                x = rbt->root;
+            }
+        }
+    }
+    x->color = 'B';
+}
+
 /**
  * @brief Search for a value in the RBT.
  * @param rbt The RBT.
@@ -952,6 +2394,45 @@ rbtNode_t *rbtSearch(rbt_t *rbt, const int v)
     return node;
 }
 
+/**
+ * @brief Search for a batch of values in the RBT (the same results as rbtSearch on each of them). The searches of a
+ *        group of up to SEARCH_BATCH_GROUP values go down the tree together, one level at a time, and each of them
+ *        prefetches its next node: its cache miss is served while the other searches of the group take their step.
+ * @param rbt The RBT.
+ * @param values Values to be searched.
+ * @param n Number of values.
+ * @param results RBT node containing each value, if it exists; otherwise, NIL (output).
+ */
+void rbtSearchBatch(rbt_t *rbt, const int *values, const unsigned int n, rbtNode_t **results)
+{
+    unsigned int pending[SEARCH_BATCH_GROUP], numPending, i, j, k;
+    rbtNode_t *node;
+    for (i = 0; i < n; i += SEARCH_BATCH_GROUP)
+    {
+        numPending = 0;
+        for (j = i; j < n && j < i + SEARCH_BATCH_GROUP; j++)
+        {
+            results[j] = rbt->root;
+            pending[numPending++] = j;
+        }
+        // A search that ends leaves its place to the last pending one.
+        while (numPending > 0)
+            for (k = 0; k < numPending;)
+            {
+                j = pending[k];
+                node = results[j];
+                if (node == rbt->nil || values[j] == node->value)
+                    pending[k] = pending[--numPending];
+                else
+                {
+                    results[j] = values[j] < node->value ? node->left : node->right;
+                    __builtin_prefetch(results[j]);
+                    k++;
+                }
+            }
+    }
+}
+
 /**
  * @brief Print RBT in order.
  * @param rbt RBT to be printed.
@@ -973,25 +2454,42 @@ void rbtInOrder(rbt_t *rbt, rbtNode_t *x)
  */
 bool rbtTest()
 {
-    bool test, testSearch;
-    rbt_t *rbt = createRbt();
+    bool test = true, testSearch;
+    rbt_t *rbt;
     rbtNode_t *nodo;
-    for (int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
-    {
-        nodo = createRbtNode(i);
-        rbtInsert(rbt, nodo);
-    }
-    testSearch = true;
-    for (int j = 0; j < NUM_ELEMENTS_FOR_TEST; j++)
+    // With the nodes allocated by malloc, then from a node pool.
+    for (int pooled = 0; pooled < 2; pooled++)
     {
-        nodo = rbtSearch(rbt, j);
-        if (nodo->value != j) testSearch = false;
+        rbt = createRbt(pooled);
+        for (int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+        {
+            nodo = createRbtNode(rbt->pool, i);
+            rbtInsert(rbt, nodo);
+        }
+        testSearch = true;
+        for (int j = 0; j < NUM_ELEMENTS_FOR_TEST; j++)
+        {
+            nodo = rbtSearch(rbt, j);
+            if (nodo->value != j) testSearch = false;
+        }
+        if (!testSearch || !isRbt(rbt))
+            test = false;
+        // Heavy deletion: 9 values out of 10, in a scattered order, checking the RBT every few deletions.
+        for (unsigned int i = 0; i < NUM_ELEMENTS_FOR_TEST; i++)
+        {
+            int j = (int)((i * 7919ULL) % NUM_ELEMENTS_FOR_TEST);
+            if (j % 10 != 0)
+                rbtDelete(rbt, rbtSearch(rbt, j));
+            if (i % 50 == 0 && !isRbt(rbt))
+                test = false;
+        }
+        for (unsigned int j = 0; j < NUM_ELEMENTS_FOR_TEST; j++)
+            if ((rbtSearch(rbt, j) != rbt->nil) != (j % 10 == 0))
+                test = false;
+        if (!isRbt(rbt))
+            test = false;
+        rbtFree(rbt);
     }
-    if (testSearch && isRbt(rbt))
-        test = true;
-    else
-        test = false;
-    rbtFree(rbt);
     return test;
 }
 
@@ -1002,7 +2500,7 @@ bool rbtTest()
  */
 bool isRbt(rbt_t *rbt)
 {
-    if (rbtComputeBlackHeight(rbt, rbt->root) != -1 && rbtHasBstProperty(rbt))
+    if (rbt->root->color == 'B' && rbt->nil->color == 'B' && rbtComputeBlackHeight(rbt, rbt->root) != -1 && rbtHasBstProperty(rbt))
         return true;
     else
         return false;
@@ -1019,15 +2517,13 @@ bool rbtHasBstProperty(rbt_t *rbt)
     rbtTestStructure_t *testStructure = malloc(sizeof(rbtTestStructure_t));
     testStructure->index = 0;
     testStructure->A = malloc(sizeof(rbtTestStructure_t) * rbt->size);
+    bool test;
     rbtHasBstPropertyUtil(rbt, node, testStructure); //se bst corretto, ritorna array ordinato dato dalla visita in order
-    if (isSorted(testStructure->A, testStructure->index))
-    {
-        free(testStructure->A);
-        free(testStructure);
-        return true;
-    }
-    else
-        return false;
+    // The visit must also reach every node (e.g., none lost by a deletion).
+    test = testStructure->index == (int)rbt->size && isSorted(testStructure->A, testStructure->index);
+    free(testStructure->A);
+    free(testStructure);
+    return test;
 }
 
 /**
@@ -1053,7 +2549,7 @@ void rbtHasBstPropertyUtil(rbt_t *rbt, rbtNode_t *x, rbtTestStructure_t *rbtTest
  * @brief Function that computes the black height of the RBT.
  * @param rbt The RBT.
  * @param x Current RBT node.
- * @return Black height if all paths have the same black height; otherwise, -1.
+ * @return Black height if all paths have the same black height and no red node has a red child; otherwise, -1.
  */
 int rbtComputeBlackHeight(rbt_t *rbt, rbtNode_t *x)
 {
@@ -1066,6 +2562,8 @@ int rbtComputeBlackHeight(rbt_t *rbt, rbtNode_t *x)
         left = rbtComputeBlackHeight(rbt, x->left);
         if (left == -1 || right == -1 || left != right)
             return -1;
+        else if (x->color == 'R' && (x->left->color == 'R' || x->right->color == 'R'))
+            return -1;
         else
         {
             if (x->color == 'B')
@@ -1098,42 +2596,513 @@ void rbtFreeNodes(rbt_t *T, rbtNode_t *x)
 void rbtFree(rbt_t *T)
 {
     rbtNode_t *x = T->root;
-    rbtFreeNodes(T, x);
+    // The nodes of a pool are freed with the pool, without visiting the tree.
+    if (T->pool != NULL)
+        nodePoolRelease(T->pool);
+    else
+        rbtFreeNodes(T, x);
     free(T->nil);
     free(T);
 }
 
 // ----- End of RBT ----- //
 
+// ----- B+ TREE ----- //
+
+/**
+ * @brief Create new B+ tree node, with no keys.
+ * @param leaf Is it a leaf?
+ * @return Created B+ tree node.
+ */
+btreeNode_t *createBtreeNode(const bool leaf)
+{
+    // A leaf has only the pointer to the next leaf; the size is rounded up to whole cache lines.
+    size_t size = offsetof(btreeNode_t, children) + (leaf ? 1 : BTREE_KEYS + 1) * sizeof(btreeNode_t *);
+    btreeNode_t *node = aligned_alloc(BTREE_ALIGNMENT, (size + BTREE_ALIGNMENT - 1) / BTREE_ALIGNMENT * BTREE_ALIGNMENT);
+    if (!node)
+        return NULL;
+    for (int i = 0; i < BTREE_KEYS; i++)
+        node->keys[i] = INT_MAX;
+    node->numKeys = 0;
+    node->leaf = leaf;
+    node->children[0] = NULL;
+    return node;
+}
+
+/**
+ * @brief Create new B+ tree.
+ * @return Created B+ tree.
+ */
+btree_t *createBtree()
+{
+    btree_t *btree = malloc(sizeof(btree_t));
+    btree->size = 0;
+    btree->height = 1;
+    btree->root = createBtreeNode(true);
+    return btree;
+}
+
+/**
+ * @brief Count the keys of a B+ tree node less than a value, comparing all the BTREE_KEYS keys at once (SSE2, when
+ *        available): the unused ones are INT_MAX, so no branch depends on the keys or on their number.
+ * @param node The B+ tree node.
+ * @param v The value.
+ * @return Number of keys less than v (i.e., the child to descend into, or the position of v in a leaf).
+ */
+int btreeRank(const btreeNode_t *node, const int v)
+{
+#ifdef __SSE2__
+    const __m128i value = _mm_set1_epi32(v);
+    __m128i count = _mm_setzero_si128();
+    // Each lane of a comparison is -1 where the key is less than v.
+    for (int i = 0; i < BTREE_KEYS; i += 4)
+        count = _mm_sub_epi32(count, _mm_cmplt_epi32(_mm_load_si128((const __m128i *)(node->keys + i)), value));
+    count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(1, 0, 3, 2)));
+    count = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(count);
+#else
+    int count = 0;
+    for (int i = 0; i < BTREE_KEYS; i++)
+        count += node->keys[i] < v;
+    return count;
+#endif
+}
+
+/**
+ * @brief Insert value in the subtree of a B+ tree node, splitting the full nodes on the way back.
+ * @param btree The B+ tree.
+ * @param node Root of the subtree.
+ * @param v Value to be inserted.
+ * @param separator First key of the new right sibling of the node, if it has been split (output).
+ * @param sibling New right sibling of the node, if it has been split (output).
+ * @return True if the node has been split; otherwise, false.
+ */
+bool btreeInsertNode(btree_t *btree, btreeNode_t *node, const int v, int *separator, btreeNode_t **sibling)
+{
+    int keys[BTREE_KEYS + 1], i = btreeRank(node, v), key = v, half;
+    btreeNode_t *children[BTREE_KEYS + 2], *child = NULL, *right;
+    // In an inner node, the key and the child to be inserted come from the split of a child.
+    if (!node->leaf && !btreeInsertNode(btree, node->children[i], v, &key, &child))
+        return false;
+    if (node->numKeys < BTREE_KEYS)
+    {
+        memmove(node->keys + i + 1, node->keys + i, (node->numKeys - i) * sizeof(int));
+        node->keys[i] = key;
+        if (!node->leaf)
+        {
+            memmove(node->children + i + 2, node->children + i + 1, (node->numKeys - i) * sizeof(btreeNode_t *));
+            node->children[i + 1] = child;
+        }
+        node->numKeys++;
+        return false;
+    }
+    // Full node: its BTREE_KEYS + 1 keys are split with a new right sibling.
+    memcpy(keys, node->keys, i * sizeof(int));
+    keys[i] = key;
+    memcpy(keys + i + 1, node->keys + i, (BTREE_KEYS - i) * sizeof(int));
+    if (!node->leaf)
+    {
+        memcpy(children, node->children, (i + 1) * sizeof(btreeNode_t *));
+        children[i + 1] = child;
+        memcpy(children + i + 2, node->children + i + 1, (BTREE_KEYS - i) * sizeof(btreeNode_t *));
+    }
+    right = createBtreeNode(node->leaf);
+    half = (BTREE_KEYS + 1) / 2;
+    for (int j = 0; j < BTREE_KEYS; j++)
+        node->keys[j] = j < half ? keys[j] : INT_MAX;
+    node->numKeys = half;
+    *separator = keys[half];
+    if (node->leaf)
+    {
+        // The right leaf starts with the separator, and follows the node in the list of the leaves.
+        right->numKeys = BTREE_KEYS + 1 - half;
+        memcpy(right->keys, keys + half, right->numKeys * sizeof(int));
+        right->children[0] = node->children[0];
+        node->children[0] = right;
+    }
+    else
+    {
+        // The separator moves up: the right node gets the keys after it.
+        right->numKeys = BTREE_KEYS - half;
+        memcpy(right->keys, keys + half + 1, right->numKeys * sizeof(int));
+        memcpy(node->children, children, (half + 1) * sizeof(btreeNode_t *));
+        memcpy(right->children, children + half + 1, (right->numKeys + 1) * sizeof(btreeNode_t *));
+    }
+    *sibling = right;
+    return true;
+}
+
+/**
+ * @brief Insert value in the B+ tree (like rbtInsert, duplicates are kept).
+ * @param btree The B+ tree.
+ * @param v Value to be inserted.
+ */
+void btreeInsert(btree_t *btree, const int v)
+{
+    int separator;
+    btreeNode_t *sibling, *root;
+    if (btreeInsertNode(btree, btree->root, v, &separator, &sibling))
+    {
+        // The root has been split: the tree grows by one level.
+        root = createBtreeNode(false);
+        root->keys[0] = separator;
+        root->numKeys = 1;
+        root->children[0] = btree->root;
+        root->children[1] = sibling;
+        btree->root = root;
+        btree->height++;
+    }
+    btree->size++;
+}
+
+/**
+ * @brief Find the first key of the B+ tree not less than a value.
+ * @param btree The B+ tree.
+ * @param v The value.
+ * @param i Position of the key in its leaf (output).
+ * @return Leaf containing the key, if it exists; otherwise, NULL.
+ */
+btreeNode_t *btreeLowerBound(btree_t *btree, const int v, int *i)
+{
+    btreeNode_t *node = btree->root;
+    // Every key of the children before the chosen one is less than v.
+    while (!node->leaf)
+        node = node->children[btreeRank(node, v)];
+    // The key is in this leaf or, if all its keys are less than v, at the start of the next one (e.g., equal to the
+    // separator).
+    while (node != NULL && (*i = btreeRank(node, v)) == node->numKeys)
+        node = node->children[0];
+    return node;
+}
+
+/**
+ * @brief Search for a value in the B+ tree.
+ * @param btree The B+ tree.
+ * @param v Value to be searched.
+ * @return Key equal to the value in its leaf, if it exists; otherwise, NULL.
+ */
+int *btreeSearch(btree_t *btree, const int v)
+{
+    int i;
+    btreeNode_t *leaf = btreeLowerBound(btree, v, &i);
+    return leaf != NULL && leaf->keys[i] == v ? &leaf->keys[i] : NULL;
+}
+
+/**
+ * @brief Refill a child of a B+ tree node with fewer than BTREE_MIN_KEYS keys: it borrows a key from a sibling with
+ *        more than BTREE_MIN_KEYS keys or, if there is none, it is merged with a sibling (at most BTREE_KEYS keys
+ *        together), and the separators of the parent are updated.
+ * @param parent Parent of the child.
+ * @param i Index of the child.
+ */
+void btreeRebalance(btreeNode_t *parent, const int i)
+{
+    btreeNode_t *node = parent->children[i], *left, *right;
+    int j = i;
+    if (i > 0 && parent->children[i - 1]->numKeys > BTREE_MIN_KEYS)
+    {
+        // The last key of the left sibling moves to the front: through the parent for an inner node.
+        left = parent->children[i - 1];
+        memmove(node->keys + 1, node->keys, node->numKeys * sizeof(int));
+        if (node->leaf)
+        {
+            node->keys[0] = left->keys[left->numKeys - 1];
+            parent->keys[i - 1] = node->keys[0];
+        }
+        else
+        {
+            memmove(node->children + 1, node->children, (node->numKeys + 1) * sizeof(btreeNode_t *));
+            node->keys[0] = parent->keys[i - 1];
+            node->children[0] = left->children[left->numKeys];
+            parent->keys[i - 1] = left->keys[left->numKeys - 1];
+        }
+        node->numKeys++;
+        left->keys[--left->numKeys] = INT_MAX;
+    }
+    else if (i < parent->numKeys && parent->children[i + 1]->numKeys > BTREE_MIN_KEYS)
+    {
+        // The first key of the right sibling moves to the end: through the parent for an inner node.
+        right = parent->children[i + 1];
+        if (node->leaf)
+        {
+            node->keys[node->numKeys] = right->keys[0];
+            parent->keys[i] = right->keys[1];
+        }
+        else
+        {
+            node->keys[node->numKeys] = parent->keys[i];
+            node->children[node->numKeys + 1] = right->children[0];
+            parent->keys[i] = right->keys[0];
+            memmove(right->children, right->children + 1, right->numKeys * sizeof(btreeNode_t *));
+        }
+        node->numKeys++;
+        memmove(right->keys, right->keys + 1, (right->numKeys - 1) * sizeof(int));
+        right->keys[--right->numKeys] = INT_MAX;
+    }
+    else
+    {
+        // Merge the child with its right sibling (the left one for the last child): the right node of the pair is
+        // freed, with its separator.
+        if (j == parent->numKeys)
+            j--;
+        left = parent->children[j];
+        right = parent->children[j + 1];
+        if (left->leaf)
+            left->children[0] = right->children[0];
+        else
+        {
+            left->keys[left->numKeys++] = parent->keys[j];
+            memcpy(left->children + left->numKeys, right->children, (right->numKeys + 1) * sizeof(btreeNode_t *));
+        }
+        memcpy(left->keys + left->numKeys, right->keys, right->numKeys * sizeof(int));
+        left->numKeys += right->numKeys;
+        free(right);
+        memmove(parent->keys + j, parent->keys + j + 1, (parent->numKeys - j - 1) * sizeof(int));
+        memmove(parent->children + j + 1, parent->children + j + 2, (parent->numKeys - j - 1) * sizeof(btreeNode_t *));
+        parent->keys[--parent->numKeys] = INT_MAX;
+    }
+}
+
+/**
+ * @brief Delete one occurrence of a value from the subtree of a B+ tree node, refilling the children left with fewer
+ *        than BTREE_MIN_KEYS keys on the way back (so that the leaves stay at least half full and the height
+ *        logarithmic).
+ * @param node Root of the subtree.
+ * @param v Value to be deleted.
+ * @return True if the value has been found and deleted; otherwise, false.
+ */
+bool btreeDeleteNode(btreeNode_t *node, const int v)
+{
+    int i = btreeRank(node, v);
+    if (node->leaf)
+    {
+        if (i == node->numKeys || node->keys[i] != v)
+            return false;
+        memmove(node->keys + i, node->keys + i + 1, (node->numKeys - i - 1) * sizeof(int));
+        node->keys[--node->numKeys] = INT_MAX;
+        return true;
+    }
+    // Children[i] is the first one that can hold v; with duplicates, so are the next ones while their separator is v.
+    for (;; i++)
+    {
+        if (btreeDeleteNode(node->children[i], v))
+        {
+            if (node->children[i]->numKeys < BTREE_MIN_KEYS)
+                btreeRebalance(node, i);
+            return true;
+        }
+        if (i == node->numKeys || node->keys[i] != v)
+            return false;
+    }
+}
+
+/**
+ * @brief Delete one occurrence of a value from the B+ tree. The nodes below BTREE_MIN_KEYS keys borrow from or merge
+ *        with a sibling, and the tree loses a level when the root is left with a single child.
+ * @param btree The B+ tree.
+ * @param v Value to be deleted.
+ * @return True if the value has been found and deleted; otherwise, false.
+ */
+bool btreeDelete(btree_t *btree, const int v)
+{
+    btreeNode_t *root = btree->root;
+    if (!btreeDeleteNode(root, v))
+        return false;
+    if (!root->leaf && root->numKeys == 0)
+    {
+        btree->root = root->children[0];
+        btree->height--;
+        free(root);
+    }
+    btree->size--;
+    return true;
+}
+
+/**
+ * @brief Check the invariants of the subtree of a B+ tree node: sorted keys padded with INT_MAX, at least
+ *        BTREE_MIN_KEYS keys in every node but the root, children within the bounds of their separators and all the
+ *        leaves at the same depth.
+ * @param node Root of the subtree.
+ * @param root Is it the root of the B+ tree?
+ * @param height Number of levels of the subtree.
+ * @return True if they hold; otherwise, false.
+ */
+bool btreeIsValid(const btreeNode_t *node, const bool root, const unsigned int height)
+{
+    const btreeNode_t *child;
+    if ((!root && node->numKeys < BTREE_MIN_KEYS) || node->leaf != (height == 1) || !isSorted(node->keys, BTREE_KEYS))
+        return false;
+    for (int i = node->numKeys; i < BTREE_KEYS; i++)
+        if (node->keys[i] != INT_MAX)
+            return false;
+    for (int i = 0; !node->leaf && i <= node->numKeys; i++)
+    {
+        child = node->children[i];
+        if ((i > 0 && child->numKeys > 0 && child->keys[0] < node->keys[i - 1]) ||
+            (i < node->numKeys && child->numKeys > 0 && child->keys[child->numKeys - 1] > node->keys[i]) ||
+            !btreeIsValid(child, false, height - 1))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Test B+ tree if it is correctly implemented: values with duplicates are inserted (several levels), half of
+ *        them are deleted, and the leaves must stay sorted; then 90% of the keys of another B+ tree are deleted, and
+ *        it must keep its invariants and shrink.
+ * @return True if it is correct; otherwise, false.
+ */
+bool btreeTest()
+{
+    bool test = true;
+    const int n = 20 * NUM_ELEMENTS_FOR_TEST;
+    btree_t *btree = createBtree();
+    btreeNode_t *leaf;
+    int *A = malloc(n * sizeof(int)), numKeys = 0;
+    // Each value of [0, n / 2) twice, in a scattered order.
+    for (int i = 0; i < n; i++)
+        btreeInsert(btree, (int)((i * 7919ULL) % n) / 2);
+    for (int i = 0; i < n / 2; i++)
+        if (btreeSearch(btree, i) == NULL || *btreeSearch(btree, i) != i)
+            test = false;
+    for (int i = 0; i < n / 2; i += 2)
+        if (!btreeDelete(btree, i) || !btreeDelete(btree, i) || btreeDelete(btree, i))
+            test = false;
+    for (int i = 0; i < n / 2; i++)
+        if ((btreeSearch(btree, i) != NULL) != (i % 2 == 1))
+            test = false;
+    // The leaves, from the leftmost one, hold the remaining keys in order.
+    for (leaf = btree->root; !leaf->leaf; leaf = leaf->children[0])
+        ;
+    for (; leaf != NULL && numKeys + leaf->numKeys <= n; leaf = leaf->children[0])
+    {
+        memcpy(A + numKeys, leaf->keys, leaf->numKeys * sizeof(int));
+        numKeys += leaf->numKeys;
+    }
+    test = test && leaf == NULL && numKeys == (int)btree->size && btree->height > 2 && isSorted(A, numKeys) &&
+           btreeIsValid(btree->root, true, btree->height);
+    btreeFree(btree);
+    // Distinct values, 90% of them deleted in a scattered order: the searches for the others must not walk through
+    // empty leaves, i.e., every leaf but a root one keeps at least BTREE_MIN_KEYS keys.
+    btree = createBtree();
+    for (int i = 0; i < n; i++)
+        btreeInsert(btree, (int)((i * 7919ULL) % n));
+    for (int i = 0; i < n; i++)
+        if (i % 10 != 0 && !btreeDelete(btree, (int)((i * 7919ULL) % n)))
+            test = false;
+    for (int i = 0; i < n; i++)
+        if ((btreeSearch(btree, (int)((i * 7919ULL) % n)) != NULL) != (i % 10 == 0))
+            test = false;
+    for (leaf = btree->root, numKeys = 0; !leaf->leaf; leaf = leaf->children[0])
+        ;
+    for (; leaf != NULL; leaf = leaf->children[0])
+        numKeys++;
+    test = test && (int)btree->size == (n + 9) / 10 && numKeys <= (int)btree->size / BTREE_MIN_KEYS &&
+           btreeIsValid(btree->root, true, btree->height);
+    free(A);
+    btreeFree(btree);
+    return test;
+}
+
+/**
+ * @brief Free B+ tree nodes.
+ * @param node Root of the subtree to be freed.
+ */
+void btreeFreeNodes(btreeNode_t *node)
+{
+    for (int i = 0; !node->leaf && i <= node->numKeys; i++)
+        btreeFreeNodes(node->children[i]);
+    free(node);
+}
+
+/**
+ * @brief Free B+ tree.
+ * @param btree B+ tree to be freed.
+ */
+void btreeFree(btree_t *btree)
+{
+    btreeFreeNodes(btree->root);
+    free(btree);
+}
+
+// ----- End of B+ TREE ----- //
+
 // ----- AUXILIARY FUNCTIONS ----- //
 
 /**
- * @brief Generate a collection of random numbers.
+ * @brief Generate a collection of random numbers in the interval [1, MAX_RANDOM_NUMBER].
  * @param A Array of random numbers.
  * @param n Size of the array.
  */
 void generateRandomArray(int *A, const int n)
 {
     // For each i in 0..n-1, generate a random number.
-    for (int i = 0; i < n; i++)
-        A[i] = rand() % MAX_RANDOM_NUMBER;
+    prngFill(&randomGenerator, A, n, MAX_RANDOM_NUMBER, 1);
 }
 
 /**
- * @brief Unit test: check if the input array is sorted.
+ * @brief Generate the operations of an experiment: the insertions followed by the searches or, if there are
+ *        deletions, all of them in a random order (so that the structures churn instead of growing first).
+ * @param operations Operations.
+ * @param numInsertions Number of insert operations.
+ * @param numSearches Number of search operations.
+ * @param numDeletions Number of delete operations.
+ */
+void generateOperations(operationEnum_t *operations, const unsigned int numInsertions, const unsigned int numSearches, const unsigned int numDeletions)
+{
+    const unsigned int n = numInsertions + numSearches + numDeletions;
+    operationEnum_t swap;
+    unsigned int i, j;
+    for (i = 0; i < n; i++)
+        operations[i] = i < numInsertions ? INSERTION : i < numInsertions + numSearches ? SEARCH : DELETION;
+    // Fisher-Yates shuffle.
+    for (i = n - 1; numDeletions > 0 && i > 0; i--)
+    {
+        j = prngBounded(&randomGenerator, i + 1);
+        swap = operations[i];
+        operations[i] = operations[j];
+        operations[j] = swap;
+    }
+}
+
+/**
+ * @brief Unit test: check if the input array is sorted (shifted AVX2 loads when available, and one thread for each
+ *        core on large arrays; see verify.h).
  * @param A Array to be checked if sorted.
  * @param n Size of the array.
  * @return True if it is sorted; otherwise, false
  */
 bool isSorted(const int *A, const int n)
 {
-    // For each i in 0..n-2, if the current element is greater than the next one,
-    // then it is unsorted.
-    for (int i = 0; i < n - 1; i++)
-        if (A[i] > A[i + 1])
-            return false;
-    // Otherwise it is.
-    return true;
+    // Fewer than 2 elements are always sorted.
+    if (n < 2)
+        return true;
+    return verifyIsSorted(A, n, 0);
+}
+
+/**
+ * @brief Print the columns of the hardware performance counters of all the data structures that end a horizontal
+ *        separator of the table (nothing unless MEASURE_COUNTERS).
+ */
+void printCountersSeparator()
+{
+    for (int c = 0; MEASURE_COUNTERS && c < 4 * PERF_NUM_COUNTERS; c++)
+        fprintf(outputPointer, "---------------+");
+}
+
+/**
+ * @brief Print a hardware performance counter for each operation as a column of the table ("n/a" if it is
+ *        unavailable, e.g., without MEASURE_COUNTERS).
+ * @param counters Hardware performance counters.
+ * @param counter Index of the counter (in the order of perfCounterNames).
+ * @param numOperations Number of operations.
+ */
+void printCounterPerOperation(const perfValues_t *counters, const int counter, const unsigned int numOperations)
+{
+    if (isnan(counters->values[counter]) || numOperations == 0)
+        fprintf(outputPointer, " %10s |", "n/a");
+    else
+        fprintf(outputPointer, " %10.2f |", counters->values[counter] / numOperations);
 }
 
 // ----- End of AUXILIARY FUNCTIONS ----- //
@@ -1142,59 +3111,402 @@ bool isSorted(const int *A, const int n)
 
 /**
  * @brief Function that does the experiment.
- * @param randomArray Array of random numbers.
- * @param numInsertions Number of insertion operations.
- * @param numSearches Number of search operations.
- * @param dataStructure Data structure to be used. The possible values are: hashtable and rbt.
- * @return Elapsed time for the experiment.
- */
-clock_t doExperiment(int *randomArray, const unsigned int numInsertions, const unsigned int numSearches, char *dataStructure)
+ * @param randomArray Array of random keys: PREFILL_KEYS keys inserted before the timed region, followed by the key of
+ *                    each operation (generated outside of the timed region).
+ * @param operations Operations: insertion, search or deletion (of the first node found) of their keys.
+ * @param numOperations Number of operations.
+ * @param dataStructure Data structure to be used. The possible values are: hashtable, rbt, swisstable (with as many
+ *                      slots as the hashtable has entries, so that both start at the same load factor; it doubles
+ *                      when the keys would fill more than 7/16 of them, while the hashtable keeps its m entries) and
+ *                      btree.
+ * @param counters Hardware performance counters of the experiment (unavailable unless MEASURE_COUNTERS).
+ * @param found Number of searches that found their key (output): the result of every search is used, so that the
+ *              compiler cannot drop the searches without side effects (e.g., swisstableSearch).
+ * @return Elapsed time for the experiment (monotonic clock), in nanoseconds.
+ */
+unsigned long long doExperiment(int *randomArray, operationEnum_t *operations, const unsigned int numOperations, char *dataStructure, perfValues_t *counters,
+                                unsigned int *found)
 {
-    hashtable_t *hashTable = createHashtable(NUM_ENTRIES);
-    rbt_t *rbt = createRbt();
+    hashtable_t *hashTable = createHashtable(NUM_ENTRIES, HASHTABLE_RESIZABLE, NODE_POOLS);
+    rbt_t *rbt = createRbt(NODE_POOLS);
+    swisstable_t *swissTable = createSwisstable(NUM_ENTRIES);
+    btree_t *btree = createBtree();
     rbtNode_t *nodeRbt;
-    clock_t start, end = 0;
-    linkedListNode_t *nodeHashTable; //Genera warning: non in uso ma necessaria per fare test
+    unsigned long long start, end = 0;
+    linkedListNode_t *nodeHashTable;
+    int *slotSwissTable;
+    unsigned int hits = 0;
     int key, i;
-    start = clock();
+    int *keys = randomArray + PREFILL_KEYS;
+    if (strcmp(dataStructure, "hashtable") != 0 && strcmp(dataStructure, "rbt") != 0 && strcmp(dataStructure, "swisstable") != 0 &&
+        strcmp(dataStructure, "btree") != 0)
+    {
+        fprintf(stderr, "ERROR: There is no such sorting alghoritm called %s \n", dataStructure);
+        exit(1);
+    }
+    // The structure starts with PREFILL_KEYS keys, outside of the timed region.
+    for (i = 0; i < PREFILL_KEYS; i++)
+        if (strcmp(dataStructure, "hashtable") == 0)
+            hashtableInsert(hashTable, randomArray[i]);
+        else if (strcmp(dataStructure, "rbt") == 0)
+            rbtInsert(rbt, createRbtNode(rbt->pool, randomArray[i]));
+        else if (strcmp(dataStructure, "swisstable") == 0)
+            swisstableInsert(swissTable, randomArray[i]);
+        else
+            btreeInsert(btree, randomArray[i]);
+    perfCountersStart(&perfCounters);
+    start = benchmarkNowNs();
     if (strcmp(dataStructure, "hashtable") == 0)
     {
-        for (i = 0; i < numInsertions; i++)
+        for (i = 0; i < numOperations; i++)
         {
-            key = rand() % MAX_RANDOM_NUMBER + 1;
-            hashtableInsert(hashTable, key);
-        }
-        for (i = 0; i < numSearches; i++)
-        {
-            key = rand() % MAX_RANDOM_NUMBER + 1;
-            nodeHashTable = hashtableSearch(hashTable, key);
+            key = keys[i];
+            if (operations[i] == INSERTION)
+                hashtableInsert(hashTable, key);
+            else if (operations[i] == SEARCH)
+                hits += hashtableSearch(hashTable, key) != NULL;
+            else if ((nodeHashTable = hashtableSearch(hashTable, key)) != NULL)
+                hashtableDelete(hashTable, nodeHashTable);
         }
     }
     else if (strcmp(dataStructure, "rbt") == 0)
     {
-        for (i = 0; i < numInsertions; i++)
+        for (i = 0; i < numOperations; i++)
         {
-            key = rand() % MAX_RANDOM_NUMBER + 1;
-            nodeRbt = createRbtNode(key);
-            rbtInsert(rbt, nodeRbt);
+            key = keys[i];
+            if (operations[i] == INSERTION)
+            {
+                nodeRbt = createRbtNode(rbt->pool, key);
+                rbtInsert(rbt, nodeRbt);
+            }
+            else if (operations[i] == SEARCH)
+                hits += rbtSearch(rbt, key) != rbt->nil;
+            else if ((nodeRbt = rbtSearch(rbt, key)) != rbt->nil)
+                rbtDelete(rbt, nodeRbt);
         }
-        for (i = 0; i < numSearches; i++)
+    }
+    else if (strcmp(dataStructure, "swisstable") == 0)
+    {
+        for (i = 0; i < numOperations; i++)
         {
-            key = rand() % MAX_RANDOM_NUMBER + 1;
-            nodeRbt = rbtSearch(rbt, key);
+            key = keys[i];
+            if (operations[i] == INSERTION)
+                swisstableInsert(swissTable, key);
+            else if (operations[i] == SEARCH)
+                hits += swisstableSearch(swissTable, key) != NULL;
+            else if ((slotSwissTable = swisstableSearch(swissTable, key)) != NULL)
+                swisstableDelete(swissTable, slotSwissTable);
         }
     }
     else
     {
-        fprintf(stderr, "ERROR: There is no such sorting alghoritm called %s \n", dataStructure);
-        exit(1);
+        for (i = 0; i < numOperations; i++)
+        {
+            key = keys[i];
+            if (operations[i] == INSERTION)
+                btreeInsert(btree, key);
+            else if (operations[i] == SEARCH)
+                hits += btreeSearch(btree, key) != NULL;
+            else
+                btreeDelete(btree, key);
+        }
     }
-    end = clock();
+    end = benchmarkNowNs();
+    perfCountersStop(&perfCounters, counters);
     hashtableFree(hashTable);
     rbtFree(rbt);
+    swisstableFree(swissTable);
+    btreeFree(btree);
+    *found = hits;
     return end - start;
 }
 
+/**
+ * @brief Job of the experiment: all the data structures on the same keys and operations, drawn from the random stream
+ *        of the job (so that the results do not depend on the thread running it).
+ * @param context Jobs of a number of operations (operationsJobs_t).
+ * @param job Index of the job.
+ */
+void operationsJob(void *context, int job)
+{
+    operationsJobs_t *jobs = context;
+    const unsigned int numOperations = jobs->numInsertions + jobs->numSearches + jobs->numDeletions;
+    // Allocate the random keys (prefill, then one for each operation) and the operations.
+    int *randomArray = malloc((PREFILL_KEYS + numOperations) * sizeof(int));
+    operationEnum_t *operations = malloc(numOperations * sizeof(operationEnum_t));
+    unsigned int found[4];
+    // The generator of the thread is replaced by the stream of the job only for the job.
+    prng_t saved = randomGenerator;
+    runnerSeedJob(&randomGenerator, RANDOM_SEED, (uint64_t)jobs->row * (NUM_WARMUP_RUNS + NUM_EXPERIMENTS) + job);
+    generateRandomArray(randomArray, PREFILL_KEYS + numOperations);
+    generateOperations(operations, jobs->numInsertions, jobs->numSearches, jobs->numDeletions);
+    randomGenerator = saved;
+    jobs->timesHashtable[job] = doExperiment(randomArray, operations, numOperations, "hashtable", &jobs->countersHashtable[job], &found[0]);
+    jobs->timesRbt[job] = doExperiment(randomArray, operations, numOperations, "rbt", &jobs->countersRbt[job], &found[1]);
+    jobs->timesSwisstable[job] = doExperiment(randomArray, operations, numOperations, "swisstable", &jobs->countersSwisstable[job], &found[2]);
+    jobs->timesBtree[job] = doExperiment(randomArray, operations, numOperations, "btree", &jobs->countersBtree[job], &found[3]);
+    // All the data structures keep the duplicates and delete one copy of a key, so their searches find the same keys.
+    if (found[1] != found[0] || found[2] != found[0] || found[3] != found[0])
+        fprintf(stderr, "ERROR: The searches found %u, %u, %u and %u keys in the hashtable, rbt, swisstable and btree\n", found[0], found[1],
+                found[2], found[3]);
+    free(operations);
+    free(randomArray);
+}
+
+/**
+ * @brief Start of a worker of the runner: open its hardware performance counters, if requested.
+ */
+void operationsJobThreadStart()
+{
+    if (MEASURE_COUNTERS)
+        perfCountersOpen(&perfCounters);
+}
+
+/**
+ * @brief End of a worker of the runner: close its hardware performance counters.
+ */
+void operationsJobThreadEnd()
+{
+    perfCountersClose(&perfCounters);
+}
+
+/**
+ * @brief Resize experiment: latency of each of RESIZE_EXPERIMENT_INSERTIONS insertions of random keys into a hashtable
+ *        of NUM_ENTRIES entries that keeps its size, that resizes incrementally (HASHTABLE_REHASH_STEP old entries for
+ *        each operation) and that resizes all at once, then the mean time of a search for an inserted key.
+ * @param benchmarkPointer Machine-readable output of the statistics of the insert latencies (NULL: none).
+ */
+void resizeExperiment(FILE *benchmarkPointer)
+{
+    const char *names[] = {"Static", "Incremental", "All at once"};
+    const char *series[] = {"static", "incremental", "all-at-once"};
+    const unsigned int n = RESIZE_EXPERIMENT_INSERTIONS, numSearches = 100, rehashStep = HASHTABLE_REHASH_STEP;
+    int *keys = malloc(n * sizeof(int));
+    double *sorted = malloc(n * sizeof(double));
+    benchmarkSamples_t latencies;
+    benchmarkStats_t stats;
+    hashtable_t *hashtbl;
+    unsigned long long start, searchTime;
+    unsigned int i;
+
+    // Keys in [1, 2^31 - 1], so that the entries of a large hashtable are all used.
+    prngFill(&randomGenerator, keys, n, 2147483647u, 1);
+    benchmarkSamplesInit(&latencies);
+    fprintf(outputPointer, "\nResize, %u insertions from %u entries (maximum load factor %.2f), time in ns\n", n, NUM_ENTRIES, HASHTABLE_MAX_LOAD);
+    fprintf(outputPointer, "+--------------+--------------+--------------+--------------+--------------+--------------+--------------+\n");
+    fprintf(outputPointer, "| Hashtable    | Insert p50   | Insert p99   | Insert p99.9 | Insert max   | Search mean  | Entries      |\n");
+    fprintf(outputPointer, "+--------------+--------------+--------------+--------------+--------------+--------------+--------------+\n");
+    for (int mode = 0; mode < 3; mode++)
+    {
+        hashtbl = createHashtable(NUM_ENTRIES, mode > 0, NODE_POOLS);
+        HASHTABLE_REHASH_STEP = mode == 2 ? 0 : rehashStep;
+        benchmarkSamplesReset(&latencies);
+        for (i = 0; i < n; i++)
+        {
+            start = benchmarkNowNs();
+            hashtableInsert(hashtbl, keys[i]);
+            benchmarkSamplesAdd(&latencies, benchmarkNowNs() - start);
+        }
+        start = benchmarkNowNs();
+        for (i = 0; i < numSearches; i++)
+            if (hashtableSearch(hashtbl, keys[(unsigned long long)i * n / numSearches]) == NULL)
+                fprintf(stderr, "ERROR: Key %d not found in the %s hashtable\n", keys[(unsigned long long)i * n / numSearches], series[mode]);
+        searchTime = benchmarkNowNs() - start;
+        // The tail beyond the 99th percentile is where a full rehash shows.
+        memcpy(sorted, latencies.values, n * sizeof(double));
+        qsort(sorted, n, sizeof(double), benchmarkCompareDoubles);
+        stats = benchmarkComputeStats(&latencies);
+        fprintf(outputPointer, "| %-12s | %12.0f | %12.0f | %12.0f | %12.0f | %12.0f | %12u |\n", names[mode], stats.median, stats.p99,
+                sorted[(999ULL * n + 999) / 1000 - 1], sorted[n - 1], (double)searchTime / numSearches, hashtbl->size);
+        benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, "resize-insert", series[mode], n, &stats);
+        hashtableFree(hashtbl);
+    }
+    fprintf(outputPointer, "+--------------+--------------+--------------+--------------+--------------+--------------+--------------+\n");
+    HASHTABLE_REHASH_STEP = rehashStep;
+    benchmarkSamplesFree(&latencies);
+    free(sorted);
+    free(keys);
+}
+
+/**
+ * @brief B+ tree experiment: the B+ tree and the RBT grow by factors of 10 from 1000 to BTREE_EXPERIMENT_MAX_KEYS random
+ *        keys (the RBT up to BTREE_EXPERIMENT_MAX_RBT_KEYS), and at each size BTREE_EXPERIMENT_SEARCHES searches for
+ *        inserted keys report the mean time and the cache and TLB misses of a search (n/a unless MEASURE_COUNTERS).
+ *        Beyond the size of the caches, a search misses about once for each level, and the B+ tree has far fewer.
+ * @param benchmarkPointer Machine-readable output of the statistics of the search times (NULL: none).
+ */
+void btreeExperiment(FILE *benchmarkPointer)
+{
+    const char *series[] = {"btree", "rbt"};
+    const unsigned int n = BTREE_EXPERIMENT_MAX_KEYS, numSearches = BTREE_EXPERIMENT_SEARCHES;
+    int *keys = malloc(n * sizeof(int)), *searches = malloc(numSearches * sizeof(int));
+    btree_t *btree = createBtree();
+    rbt_t *rbt = createRbt(NODE_POOLS);
+    perfValues_t counters;
+    benchmarkSamples_t samples;
+    benchmarkStats_t stats;
+    unsigned long long size, start, time;
+    unsigned int built = 0, found, i;
+    bool withRbt;
+
+    // Keys in [1, 2^31 - 1], so that the structures grow past the caches with (almost) distinct keys.
+    prngFill(&randomGenerator, keys, n, 2147483647u, 1);
+    benchmarkSamplesInit(&samples);
+    if (MEASURE_COUNTERS)
+        perfCountersOpen(&perfCounters);
+    fprintf(outputPointer, "\nB+ tree (%d keys for each node) vs RBT, %u searches for inserted keys, time in ns and misses for each search\n", BTREE_KEYS, numSearches);
+    fprintf(outputPointer, "+------------+--------+------------+------------+------------+------------+------------+------------+------------+------------+\n");
+    fprintf(outputPointer, "| Keys       | Height | B+ tree    | L1d-misses | LLC-misses | dTLB-miss  | RBT        | L1d-misses | LLC-misses | dTLB-miss  |\n");
+    fprintf(outputPointer, "+------------+--------+------------+------------+------------+------------+------------+------------+------------+------------+\n");
+    for (size = 1000; n > 0; size *= 10)
+    {
+        if (size > n)
+            size = n;
+        withRbt = size <= BTREE_EXPERIMENT_MAX_RBT_KEYS;
+        for (i = built; i < size; i++)
+        {
+            btreeInsert(btree, keys[i]);
+            if (withRbt)
+                rbtInsert(rbt, createRbtNode(rbt->pool, keys[i]));
+        }
+        built = size;
+        for (i = 0; i < numSearches; i++)
+            searches[i] = keys[prngBounded(&randomGenerator, size)];
+        fprintf(outputPointer, "| %10llu | %6u |", size, btree->height);
+        for (int structure = 0; structure < 2; structure++)
+        {
+            if (structure == 1 && !withRbt)
+            {
+                fprintf(outputPointer, " %10s | %10s | %10s | %10s |", "-", "-", "-", "-");
+                continue;
+            }
+            found = 0;
+            perfCountersStart(&perfCounters);
+            start = benchmarkNowNs();
+            if (structure == 0)
+                for (i = 0; i < numSearches; i++)
+                    found += btreeSearch(btree, searches[i]) != NULL;
+            else
+                for (i = 0; i < numSearches; i++)
+                    found += rbtSearch(rbt, searches[i]) != rbt->nil;
+            time = benchmarkNowNs() - start;
+            perfCountersStop(&perfCounters, &counters);
+            if (found != numSearches)
+                fprintf(stderr, "ERROR: %u of %u keys not found in the %s\n", numSearches - found, numSearches, series[structure]);
+            fprintf(outputPointer, " %10.1f |", (double)time / numSearches);
+            printCounterPerOperation(&counters, 3, numSearches);
+            printCounterPerOperation(&counters, 4, numSearches);
+            printCounterPerOperation(&counters, 5, numSearches);
+            // The mean time of a search, as a single sample.
+            benchmarkSamplesReset(&samples);
+            benchmarkSamplesAdd(&samples, (double)time / numSearches);
+            stats = benchmarkComputeStats(&samples);
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, "btree-search", series[structure], (int)size, &stats);
+        }
+        fprintf(outputPointer, "\n");
+        if (size == n)
+            break;
+    }
+    fprintf(outputPointer, "+------------+--------+------------+------------+------------+------------+------------+------------+------------+------------+\n");
+    perfCountersClose(&perfCounters);
+    benchmarkSamplesFree(&samples);
+    btreeFree(btree);
+    rbtFree(rbt);
+    free(searches);
+    free(keys);
+}
+
+/**
+ * @brief Batch experiment: a hashtable with BATCH_EXPERIMENT_KEYS random keys and as many entries, and an RBT with the
+ *        same keys, both far larger than the caches; BATCH_EXPERIMENT_SEARCHES searches for inserted keys run one at a
+ *        time (hashtableSearch, rbtSearch), then in batches of 1, 2, 4, ..., SEARCH_BATCH_GROUP keys
+ *        (hashtableSearchBatch, rbtSearchBatch), reporting the mean time of a search and the speedup.
+ * @param benchmarkPointer Machine-readable output of the statistics of the search times (NULL: none).
+ */
+void batchExperiment(FILE *benchmarkPointer)
+{
+    const char *series[] = {"hashtable", "rbt"};
+    const unsigned int n = BATCH_EXPERIMENT_KEYS, numSearches = BATCH_EXPERIMENT_SEARCHES;
+    int *keys = malloc(n * sizeof(int)), *searches = malloc(numSearches * sizeof(int));
+    linkedListNode_t **nodesHashtable = malloc(numSearches * sizeof(linkedListNode_t *));
+    rbtNode_t **nodesRbt = malloc(numSearches * sizeof(rbtNode_t *));
+    hashtable_t *hashtbl = createHashtable(n > 0 ? n : 1, false, NODE_POOLS);
+    rbt_t *rbt = createRbt(NODE_POOLS);
+    benchmarkSamples_t samples;
+    benchmarkStats_t stats;
+    unsigned long long start;
+    double times[2], single[2];
+    unsigned int batch, found[2], i;
+
+    if (n == 0)
+    {
+        fprintf(stderr, "ERROR: The batch experiment needs at least one key\n");
+        exit(1);
+    }
+    // Keys in [1, 2^31 - 1], so that the entries of the hashtable are all used.
+    prngFill(&randomGenerator, keys, n, 2147483647u, 1);
+    for (i = 0; i < n; i++)
+    {
+        hashtableInsert(hashtbl, keys[i]);
+        rbtInsert(rbt, createRbtNode(rbt->pool, keys[i]));
+    }
+    for (i = 0; i < numSearches; i++)
+        searches[i] = keys[prngBounded(&randomGenerator, n)];
+    benchmarkSamplesInit(&samples);
+    fprintf(outputPointer, "\nBatch searches, %u searches for inserted keys among %u, time in ns for each search\n", numSearches, n);
+    fprintf(outputPointer, "+------------+------------+------------+------------+------------+\n");
+    fprintf(outputPointer, "| Batch      | Hashtable  | Speedup    | RBT        | Speedup    |\n");
+    fprintf(outputPointer, "+------------+------------+------------+------------+------------+\n");
+    // Batch 0 is the baseline: one search at a time.
+    for (batch = 0; batch <= SEARCH_BATCH_GROUP; batch = batch == 0 ? 1 : 2 * batch)
+    {
+        for (int structure = 0; structure < 2; structure++)
+        {
+            found[structure] = 0;
+            start = benchmarkNowNs();
+            if (structure == 0 && batch == 0)
+                for (i = 0; i < numSearches; i++)
+                    nodesHashtable[i] = hashtableSearch(hashtbl, searches[i]);
+            else if (structure == 0)
+                for (i = 0; i < numSearches; i += batch)
+                    hashtableSearchBatch(hashtbl, searches + i, numSearches - i < batch ? numSearches - i : batch, nodesHashtable + i);
+            else if (batch == 0)
+                for (i = 0; i < numSearches; i++)
+                    nodesRbt[i] = rbtSearch(rbt, searches[i]);
+            else
+                for (i = 0; i < numSearches; i += batch)
+                    rbtSearchBatch(rbt, searches + i, numSearches - i < batch ? numSearches - i : batch, nodesRbt + i);
+            times[structure] = (double)(benchmarkNowNs() - start) / numSearches;
+            // The nodes found must hold the keys searched.
+            for (i = 0; i < numSearches; i++)
+                found[structure] += structure == 0 ? nodesHashtable[i] != NULL && nodesHashtable[i]->value == searches[i]
+                                                   : nodesRbt[i] != rbt->nil && nodesRbt[i]->value == searches[i];
+            if (found[structure] != numSearches)
+                fprintf(stderr, "ERROR: %u of %u keys not found in the %s\n", numSearches - found[structure], numSearches, series[structure]);
+            if (batch == 0)
+                single[structure] = times[structure];
+            // The mean time of a search, as a single sample (batch 0: one at a time).
+            benchmarkSamplesReset(&samples);
+            benchmarkSamplesAdd(&samples, times[structure]);
+            stats = benchmarkComputeStats(&samples);
+            benchmarkWrite(benchmarkPointer, BENCHMARK_FORMAT, "batch-search", series[structure], batch, &stats);
+        }
+        if (batch == 0)
+            fprintf(outputPointer, "| %-10s |", "Single");
+        else
+            fprintf(outputPointer, "| %10u |", batch);
+        fprintf(outputPointer, " %10.1f | %10.2f | %10.1f | %10.2f |\n", times[0], single[0] / times[0], times[1], single[1] / times[1]);
+    }
+    fprintf(outputPointer, "+------------+------------+------------+------------+------------+\n");
+    benchmarkSamplesFree(&samples);
+    hashtableFree(hashtbl);
+    rbtFree(rbt);
+    free(nodesRbt);
+    free(nodesHashtable);
+    free(searches);
+    free(keys);
+}
+
 // ----- End of CORE FUNCTIONS ----- //
 
 // ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
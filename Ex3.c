@@ -7,12 +7,18 @@
 
 // ##### LIBRARIES ##### //
 
+#define _GNU_SOURCE      // GNU extensions (e.g., sched_setaffinity); it must precede every include.
 #include <stdio.h>   // input-output library.
 #include <stdlib.h>  // standard library.
 #include <stdbool.h> // standard boolean library.
 #include <limits.h>  // limits library.
 #include <time.h>    // time library.
 #include <string.h>  // string library.
+#include "benchmark.h" // benchmark harness.
+#include "perfcounters.h" // hardware performance counters.
+#include "prng.h"        // pseudo-random number generator.
+#include "runner.h"      // parallel experiment runner.
+#include "options.h"     // runtime parameters.
 
 // ##### End of LIBRARIES ##### //
 
@@ -127,6 +133,26 @@ typedef enum output_enum_t
     ONFILE     // On file.
 } output_enum_t;
 
+/**
+ * @brief Jobs of one number of vertices: job j is the experiment experiment = j - NUM_WARMUP_RUNS with both priority
+ *        queues, on its own graph.
+ */
+typedef struct dijkstra_jobs_t
+{
+    // Number of vertices of the graphs.
+    int num_vertices;
+    // Index of the number of vertices in the sweep (it makes the random streams of the jobs unique).
+    int row;
+    // Elapsed times with the min heap, one for each job.
+    unsigned long long *times_min_heap;
+    // Elapsed times with the queue, one for each job.
+    unsigned long long *times_queue;
+    // Hardware performance counters with the min heap, one for each job.
+    perfValues_t *counters_min_heap;
+    // Hardware performance counters with the queue, one for each job.
+    perfValues_t *counters_queue;
+} dijkstra_jobs_t;
+
 // ----- End of AUXILIARY DATA STRUCTURES ----- //
 
 // ##### End of DATA STRUCTURES ##### //
@@ -134,25 +160,69 @@ typedef enum output_enum_t
 // ##### GLOBAL VARIABLES ##### //
 
 // Random seed (important for reproducibility).
-const time_t RANDOM_SEED = 17;
+time_t RANDOM_SEED = 17;
 // Minimum number of vertices.
-const unsigned int MIN_NUM_VERTICES = 10; //10
+unsigned int MIN_NUM_VERTICES = 10; //10
 // Maximum number of vertices.
-const unsigned int MAX_NUM_VERTICES = 10000; //1000
+unsigned int MAX_NUM_VERTICES = 10000; //1000
 // Step from one experiment to another.
-const unsigned int STEP_EXPERIMENTS = 100; //10
+unsigned int STEP_EXPERIMENTS = 100; //10
 // How many experiments for a fixed number of vertices?
-const unsigned int NUM_EXPERIMENTS = 50; //50
+unsigned int NUM_EXPERIMENTS = 50; //50
+// How many untimed warmup experiments before the NUM_EXPERIMENTS timed ones?
+unsigned int NUM_WARMUP_RUNS = 2;
+// Core the experiment is pinned to (a negative value leaves it unpinned).
+int PIN_CORE = -1;
+// Machine-readable output of the statistics of the experiment (in addition to the table).
+benchmarkFormat_t BENCHMARK_FORMAT = BENCHMARK_NONE;
+// File of the machine-readable output.
+char *BENCHMARK_FILE = "results.csv";
+// Measure the hardware performance counters of do_experiment (extra columns of the table)?
+bool MEASURE_COUNTERS = false;
 // Source vertex number.
-const unsigned int SOURCE_VERTEX_NUMBER = 0;
+unsigned int SOURCE_VERTEX_NUMBER = 0;
 // Edge probability.
-const unsigned int EDGE_PROBABILITY = 100; //1.0
+unsigned int EDGE_PROBABILITY = 100; //1.0
 // Maximum weight.
-const unsigned int MAX_WEIGHT = 1000;
+unsigned int MAX_WEIGHT = 1000;
 // Output type.
-const output_enum_t output_type = ONCONSOLE;
+output_enum_t output_type = ONCONSOLE;
 // Output pointer (for printing).
 FILE *output_pointer;
+// Hardware performance counters of the current thread (opened by main and by the workers of the runner if MEASURE_COUNTERS).
+_Thread_local perfCounters_t perf_counters;
+// Generator of the graphs of the current thread (stream 0 of RANDOM_SEED for the main thread).
+_Thread_local prng_t random_generator = PRNG_INITIALIZER;
+// Number of threads running the (number of vertices, repetition) jobs (1: serial, 0: one for each core); each of them
+// holds a graph, e.g. about 3 GB for 10000 vertices with EDGE_PROBABILITY = 100.
+int EXPERIMENT_THREADS = 1;
+// Pin the threads of the experiment only to the isolated cores (isolcpus=), so that the timings stay clean?
+bool ISOLATED_CORES_ONLY = false;
+// Matrix run: values of EDGE_PROBABILITY iterated in one process (empty: EDGE_PROBABILITY only).
+optionList_t MATRIX_DENSITIES = {0, {0}};
+// Names of the output types, in the order of output_enum_t.
+const char *const OUTPUT_NAMES[] = {"console", "file", NULL};
+// Runtime parameters: the globals above that can be set from the command line or a config file (see options.h).
+option_t options[] = {
+    {"seed", OPTION_TIME, &RANDOM_SEED, "Seed of the graphs", NULL, false},
+    {"min-vertices", OPTION_UINT, &MIN_NUM_VERTICES, "Minimum number of vertices", NULL, false},
+    {"max-vertices", OPTION_UINT, &MAX_NUM_VERTICES, "Maximum number of vertices", NULL, false},
+    {"step", OPTION_UINT, &STEP_EXPERIMENTS, "Step between two numbers of vertices", NULL, false},
+    {"experiments", OPTION_UINT, &NUM_EXPERIMENTS, "Number of timed experiments for each number of vertices", NULL, false},
+    {"warmups", OPTION_UINT, &NUM_WARMUP_RUNS, "Number of untimed experiments for each number of vertices", NULL, false},
+    {"source", OPTION_UINT, &SOURCE_VERTEX_NUMBER, "Source vertex", NULL, false},
+    {"edge-probability", OPTION_UINT, &EDGE_PROBABILITY, "Probability of an edge, in percent", NULL, false},
+    {"max-weight", OPTION_UINT, &MAX_WEIGHT, "Maximum weight of an edge", NULL, false},
+    {"matrix-densities", OPTION_LIST, &MATRIX_DENSITIES, "Matrix run: edge probabilities (e.g., 10,50,100)", NULL, false},
+    {"experiment-threads", OPTION_INT, &EXPERIMENT_THREADS, "Threads running the jobs (1: serial, 0: all the cores)", NULL, false},
+    {"isolated-cores", OPTION_BOOL, &ISOLATED_CORES_ONLY, "Run the jobs only on the isolated cores", NULL, false},
+    {"pin-core", OPTION_INT, &PIN_CORE, "Core the experiment is pinned to (-1: unpinned)", NULL, false},
+    {"counters", OPTION_BOOL, &MEASURE_COUNTERS, "Measure the hardware performance counters", NULL, false},
+    {"benchmark-format", OPTION_ENUM, &BENCHMARK_FORMAT, "Machine-readable output of the statistics", benchmarkFormatNames, false},
+    {"benchmark-file", OPTION_STRING, &BENCHMARK_FILE, "File of the machine-readable output", NULL, false},
+    {"output", OPTION_ENUM, &output_type, "Output of the tables (file: results.txt)", OUTPUT_NAMES, false}};
+// Number of runtime parameters.
+const int NUM_OPTIONS = sizeof(options) / sizeof(options[0]);
 
 // ##### End of GLOBAL VARIABLES ##### //
 
@@ -514,21 +584,20 @@ graph_t graph_create(unsigned const int number_vertices, const double edge_prob)
     graph_t G;
     G.number_vertices = number_vertices;
     G.adj = malloc(number_vertices * sizeof(adj_list_node_t));
-    int prob;
-    int weight;
+    // Random draws (in [1, 100]) and weights (in [0, MAX_WEIGHT)) of the edges leaving a vertex, generated in bulk.
+    int *probs = malloc(number_vertices * sizeof(int));
+    int *weights = malloc(number_vertices * sizeof(int));
     for (int i = 0; i < number_vertices; i++)
     {
         G.adj[i].head = NULL;
+        prngFill(&random_generator, probs, number_vertices, 100, 1);
+        prngFill(&random_generator, weights, number_vertices, MAX_WEIGHT, 0);
         for (int j = 0; j < number_vertices; j++)
-        {
-            prob = rand() % 100 + 1;
-            if (i != j && (prob < edge_prob))
-            {
-                weight = rand() % MAX_WEIGHT;
-                graph_add_edge(&G, i, j, weight);
-            }
-        }
+            if (i != j && (probs[j] < edge_prob))
+                graph_add_edge(&G, i, j, weights[j]);
     }
+    free(probs);
+    free(weights);
     return G;
 }
 
@@ -752,12 +821,14 @@ void dijkstra_with_queue(graph_t *G, const unsigned int source, bool showresults
  * @brief Polymorphic function that calls different versions of Dijkstra's algorithm.
  * @param G Graph.
  * @param priority_type Priority type.
- * @return Elapsed time in clocks.
+ * @param counters Hardware performance counters of the experiment (unavailable unless MEASURE_COUNTERS).
+ * @return Elapsed time (monotonic clock) in nanoseconds.
  */
-time_t do_experiment(graph_t *G, char *priority_type)
+unsigned long long do_experiment(graph_t *G, char *priority_type, perfValues_t *counters)
 {
-    clock_t start_time, end_time = 0;
-    start_time = clock();
+    unsigned long long start_time, end_time = 0;
+    perfCountersStart(&perf_counters);
+    start_time = benchmarkNowNs();
     if (strcmp(priority_type, "min-heap") == 0)
         dijkstra(G, SOURCE_VERTEX_NUMBER, false);
     else if (strcmp(priority_type, "queue") == 0)
@@ -767,11 +838,58 @@ time_t do_experiment(graph_t *G, char *priority_type)
         fprintf(stderr, "ERROR: The type of the priority can be either min-heap or queue: %s is not allowed\n", priority_type);
         exit(-1);
     }
-    end_time = clock();
+    end_time = benchmarkNowNs();
+    perfCountersStop(&perf_counters, counters);
 
     return end_time - start_time;
 }
 
+/**
+ * @brief Print the columns of the hardware performance counters of both priority queues that end a horizontal
+ *        separator of the table (nothing unless MEASURE_COUNTERS).
+ */
+void print_counters_separator()
+{
+    for (int c = 0; MEASURE_COUNTERS && c < 2 * PERF_NUM_COUNTERS; c++)
+        fprintf(output_pointer, "---------------+");
+}
+
+/**
+ * @brief Job of the experiment: Dijkstra with both priority queues on a graph drawn from the random stream of the job
+ *        (so that the results do not depend on the thread running it).
+ * @param context Jobs of a number of vertices (dijkstra_jobs_t).
+ * @param job Index of the job.
+ */
+void dijkstra_job(void *context, int job)
+{
+    dijkstra_jobs_t *jobs = context;
+    // The generator of the thread is replaced by the stream of the job only for the job.
+    prng_t saved = random_generator;
+    runnerSeedJob(&random_generator, RANDOM_SEED, (uint64_t)jobs->row * (NUM_WARMUP_RUNS + NUM_EXPERIMENTS) + job);
+    graph_t G = graph_create(jobs->num_vertices, EDGE_PROBABILITY);
+    random_generator = saved;
+    jobs->times_min_heap[job] = do_experiment(&G, "min-heap", &jobs->counters_min_heap[job]);
+    jobs->times_queue[job] = do_experiment(&G, "queue", &jobs->counters_queue[job]);
+    graph_free(&G);
+}
+
+/**
+ * @brief Start of a worker of the runner: open its hardware performance counters, if requested.
+ */
+void dijkstra_job_thread_start()
+{
+    if (MEASURE_COUNTERS)
+        perfCountersOpen(&perf_counters);
+}
+
+/**
+ * @brief End of a worker of the runner: close its hardware performance counters.
+ */
+void dijkstra_job_thread_end()
+{
+    perfCountersClose(&perf_counters);
+}
+
 /**
  * @brief Test dijkstra with a custom graph
  */
@@ -799,14 +917,39 @@ void test()
  * @brief Main function.
  * @return 0 if all ok.
  */
-int main()
+int main(int argc, char **argv)
 {
+    // Parameters from the command line and the config file (it exits on --help or on invalid options).
+    optionsParse(argc, argv, options, NUM_OPTIONS);
+    // The options are valid one by one, but the sweep also needs them to be consistent.
+    if (STEP_EXPERIMENTS == 0 || MIN_NUM_VERTICES > MAX_NUM_VERTICES || NUM_EXPERIMENTS < 1)
+    {
+        fprintf(stderr, "ERROR: The step (%u) and the experiments (%u) must be positive, and the minimum number of vertices (%u) at most the maximum (%u)\n",
+                STEP_EXPERIMENTS, NUM_EXPERIMENTS, MIN_NUM_VERTICES, MAX_NUM_VERTICES);
+        exit(1);
+    }
     // Random seed initialization.
-    srand(RANDOM_SEED);
-    // Elapsed time using min heaps.
-    clock_t time_min_heap = 0;
-    // Elapsed time using queues.
-    clock_t time_queue = 0;
+    prngSeed(&random_generator, RANDOM_SEED, 0);
+    // Elapsed times using min heaps.
+    benchmarkSamples_t times_min_heap;
+    // Elapsed times using queues.
+    benchmarkSamples_t times_queue;
+    // Statistics of the elapsed times.
+    benchmarkStats_t stats_min_heap, stats_queue;
+    // Machine-readable output.
+    FILE *benchmark_pointer;
+    // Hardware performance counters accumulated over the experiments.
+    perfValues_t counters_min_heap, counters_queue;
+    // Runs of a number of vertices (warmups first).
+    dijkstra_jobs_t jobs;
+    // Runner of the jobs of the experiment.
+    runner_t runner;
+    // Number of runs of a number of vertices.
+    const int num_jobs = NUM_WARMUP_RUNS + NUM_EXPERIMENTS;
+    // Edge probabilities of the tables (a single one unless it is a matrix run).
+    const optionList_t densities = MATRIX_DENSITIES.size > 0 ? MATRIX_DENSITIES : (optionList_t){1, {EDGE_PROBABILITY}};
+    // Name of the experiment in the machine-readable output (with the edge probability in a matrix run).
+    char experiment[64] = "dijkstra";
 
     // What is the outputPointer?
     if (output_type == ONCONSOLE || output_type == ONFILE)
@@ -834,43 +977,112 @@ int main()
         exit(-1);
     }
 
-    // Print the header, only if it is on console.
-    if (output_type == ONCONSOLE)
+    // Pin the experiment to a core, if requested.
+    if (PIN_CORE >= 0 && !benchmarkPinToCore(PIN_CORE))
+        fprintf(stderr, "ERROR: The experiment has not been pinned to core %d\n", PIN_CORE);
+    // Open the machine-readable output, if requested.
+    benchmark_pointer = benchmarkOpen(BENCHMARK_FILE, BENCHMARK_FORMAT);
+    benchmarkSamplesInit(&times_min_heap);
+    benchmarkSamplesInit(&times_queue);
+    // Allocate the results of all the runs of a number of vertices.
+    jobs.times_min_heap = malloc(num_jobs * sizeof(unsigned long long));
+    jobs.times_queue = malloc(num_jobs * sizeof(unsigned long long));
+    jobs.counters_min_heap = malloc(num_jobs * sizeof(perfValues_t));
+    jobs.counters_queue = malloc(num_jobs * sizeof(perfValues_t));
+    // Threads of the (number of vertices, repetition) jobs, pinned to the allowed (or isolated) cores.
+    runnerInit(&runner, EXPERIMENT_THREADS, ISOLATED_CORES_ONLY, dijkstra_job_thread_start, dijkstra_job_thread_end);
+    // Open the hardware performance counters, if requested (the unavailable ones are shown as n/a).
+    if (MEASURE_COUNTERS)
     {
-        fprintf(output_pointer, "+--------------------+---------------------+---------------------+\n");
-        fprintf(output_pointer, "| Number of vertices | Min heap            | Queue               |\n");
-        fprintf(output_pointer, "+--------------------+---------------------+---------------------+\n");
+        int available = perfCountersOpen(&perf_counters);
+        if (available < PERF_NUM_COUNTERS)
+            fprintf(stderr, "ERROR: Only %d of %d hardware performance counters are available\n", available, PERF_NUM_COUNTERS);
     }
 
-    for (int num_vertices = MIN_NUM_VERTICES; num_vertices <= MAX_NUM_VERTICES; num_vertices += STEP_EXPERIMENTS)
+    // One table for each density of the matrix, in the same process (the allocator and the caches stay warm).
+    for (int cell = 0; cell < densities.size; cell++)
     {
-        // Reset the elapsed times.
-        time_min_heap = time_queue = 0;
-
-        for (int experiment = 0; experiment < NUM_EXPERIMENTS; experiment++)
+        EDGE_PROBABILITY = densities.values[cell];
+        if (MATRIX_DENSITIES.size > 0)
         {
-            // Create the graph.
-            graph_t G = graph_create(num_vertices, EDGE_PROBABILITY);
-            // Time with min heap.
-            time_min_heap += do_experiment(&G, "min-heap");
-            // Time with queue.
-            time_queue += do_experiment(&G, "queue");
-            graph_free(&G);
+            snprintf(experiment, sizeof(experiment), "dijkstra-p%u", EDGE_PROBABILITY);
+            fprintf(output_pointer, "%sEdge probability: %u%%\n", cell > 0 ? "\n" : "", EDGE_PROBABILITY);
         }
 
-        // Printing the (sample mean as) result. Use TAB (\t) on file.
+        // Print the header, only if it is on console.
         if (output_type == ONCONSOLE)
-            fprintf(output_pointer, "| %17d  | %19f | %19f |\n",
-                    num_vertices,
-                    (float)time_min_heap / NUM_EXPERIMENTS,
-                    (float)time_queue / NUM_EXPERIMENTS);
+        {
+            fprintf(output_pointer, "+--------------------+---------------------+---------------------+");
+            print_counters_separator();
+            fprintf(output_pointer, "\n| Number of vertices | Min heap            | Queue               |");
+            for (int c = 0; MEASURE_COUNTERS && c < 2 * PERF_NUM_COUNTERS; c++)
+                fprintf(output_pointer, " %-13s |", c == 0 ? "Min heap" : c == PERF_NUM_COUNTERS ? "Queue" : "");
+            fprintf(output_pointer, "\n|                    | Median time (ns)    | Median time (ns)    |");
+            if (MEASURE_COUNTERS)
+            {
+                perfHeaderPrint(output_pointer, "", " |");
+                perfHeaderPrint(output_pointer, "", " |");
+            }
+            fprintf(output_pointer, "\n+--------------------+---------------------+---------------------+");
+            print_counters_separator();
+            fprintf(output_pointer, "\n");
+        }
 
-        else
-            fprintf(output_pointer, "%d \t%f \t%f \n",
-                    num_vertices,
-                    (float)time_min_heap / NUM_EXPERIMENTS,
-                    (float)time_queue / NUM_EXPERIMENTS);
+        for (int num_vertices = MIN_NUM_VERTICES; num_vertices <= MAX_NUM_VERTICES; num_vertices += STEP_EXPERIMENTS)
+        {
+            // Reset the elapsed times.
+            benchmarkSamplesReset(&times_min_heap);
+            benchmarkSamplesReset(&times_queue);
+            perfValuesReset(&counters_min_heap);
+            perfValuesReset(&counters_queue);
+
+            // Each experiment is an independent job and the first NUM_WARMUP_RUNS ones are not timed; the results are
+            // read in the serial order.
+            jobs.num_vertices = num_vertices;
+            jobs.row = (num_vertices - MIN_NUM_VERTICES) / STEP_EXPERIMENTS;
+            runnerRun(&runner, num_jobs, dijkstra_job, &jobs);
+            for (int job = NUM_WARMUP_RUNS; job < num_jobs; job++)
+            {
+                benchmarkSamplesAdd(&times_min_heap, jobs.times_min_heap[job]);
+                benchmarkSamplesAdd(&times_queue, jobs.times_queue[job]);
+                perfValuesAdd(&counters_min_heap, &jobs.counters_min_heap[job]);
+                perfValuesAdd(&counters_queue, &jobs.counters_queue[job]);
+            }
+            stats_min_heap = benchmarkComputeStats(&times_min_heap);
+            stats_queue = benchmarkComputeStats(&times_queue);
+
+            // Printing the (sample median as) result. Use TAB (\t) on file.
+            if (output_type == ONCONSOLE)
+                fprintf(output_pointer, "| %17d  | %19f | %19f |",
+                        num_vertices,
+                        stats_min_heap.median,
+                        stats_queue.median);
+
+            else
+                fprintf(output_pointer, "%d \t%f \t%f ",
+                        num_vertices,
+                        stats_min_heap.median,
+                        stats_queue.median);
+            // Mean hardware performance counters of an experiment.
+            if (MEASURE_COUNTERS)
+            {
+                perfValuesPrint(output_pointer, &counters_min_heap, NUM_EXPERIMENTS, output_type == ONCONSOLE ? "" : "\t", output_type == ONCONSOLE ? " |" : "");
+                perfValuesPrint(output_pointer, &counters_queue, NUM_EXPERIMENTS, output_type == ONCONSOLE ? "" : "\t", output_type == ONCONSOLE ? " |" : "");
+            }
+            fprintf(output_pointer, "\n");
+            // All the statistics go to the machine-readable output.
+            benchmarkWrite(benchmark_pointer, BENCHMARK_FORMAT, experiment, "min-heap", num_vertices, &stats_min_heap);
+            benchmarkWrite(benchmark_pointer, BENCHMARK_FORMAT, experiment, "queue", num_vertices, &stats_queue);
+        }
     }
+    benchmarkSamplesFree(&times_min_heap);
+    benchmarkSamplesFree(&times_queue);
+    free(jobs.times_min_heap);
+    free(jobs.times_queue);
+    free(jobs.counters_min_heap);
+    free(jobs.counters_queue);
+    benchmarkClose(benchmark_pointer);
+    perfCountersClose(&perf_counters);
     test();
     return 0;
 }
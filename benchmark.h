@@ -0,0 +1,274 @@
+/**
+ * @brief Benchmark harness shared by the problems of the Laboratory of Algorithms and Data Structures:
+ *        monotonic nanosecond clock, per-run samples and their statistics, core pinning and CSV/JSON output.
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// ##### LIBRARIES ##### //
+
+// Standard input-output library (e.g., fprintf).
+#include <stdio.h>
+// Standard library (e.g., malloc, qsort).
+#include <stdlib.h>
+// Boolean library (e.g., bool).
+#include <stdbool.h>
+// Time library (e.g., clock_gettime).
+#include <time.h>
+// Math library (e.g., sqrt).
+#include <math.h>
+// Scheduling library (e.g., sched_setaffinity); it needs _GNU_SOURCE defined before the first include.
+#include <sched.h>
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+/**
+ * @brief Samples (one for each timed run) of a benchmark.
+ */
+typedef struct benchmarkSamples_t
+{
+    // Number of samples.
+    unsigned int size;
+    // Number of allocated samples.
+    unsigned int capacity;
+    // Samples in nanoseconds.
+    double *values;
+} benchmarkSamples_t;
+
+/**
+ * @brief Statistics of the samples of a benchmark, in nanoseconds.
+ */
+typedef struct benchmarkStats_t
+{
+    // Number of samples.
+    unsigned int runs;
+    // Minimum.
+    double min;
+    // Median.
+    double median;
+    // 90th percentile.
+    double p90;
+    // 99th percentile.
+    double p99;
+    // Mean.
+    double mean;
+    // Sample standard deviation.
+    double stddev;
+    // Lower bound of the 95% confidence interval of the mean.
+    double ciLow;
+    // Upper bound of the 95% confidence interval of the mean.
+    double ciHigh;
+} benchmarkStats_t;
+
+/**
+ * @brief Enumeration data type for the machine-readable output of the benchmarks.
+ */
+typedef enum benchmarkFormat_t
+{
+    BENCHMARK_NONE, // No machine-readable output.
+    BENCHMARK_CSV,  // Comma-separated values, one row for each statistics.
+    BENCHMARK_JSON  // JSON Lines, one object for each statistics.
+} benchmarkFormat_t;
+
+// Names of the formats, in the order of benchmarkFormat_t (e.g., for parsing the options).
+static const char *const benchmarkFormatNames[] = {"none", "csv", "json", NULL};
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief Monotonic clock in nanoseconds (wall-clock time, unaffected by changes of the system time).
+ * @return Nanoseconds elapsed from an arbitrary fixed point in the past.
+ */
+static unsigned long long benchmarkNowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/**
+ * @brief Initialize empty samples.
+ * @param samples Samples.
+ */
+static void benchmarkSamplesInit(benchmarkSamples_t *samples)
+{
+    samples->size = 0;
+    samples->capacity = 64;
+    samples->values = malloc(samples->capacity * sizeof(double));
+}
+
+/**
+ * @brief Add a sample.
+ * @param samples Samples.
+ * @param ns Sample in nanoseconds.
+ */
+static void benchmarkSamplesAdd(benchmarkSamples_t *samples, const double ns)
+{
+    if (samples->size == samples->capacity)
+    {
+        samples->capacity *= 2;
+        samples->values = realloc(samples->values, samples->capacity * sizeof(double));
+    }
+    samples->values[samples->size++] = ns;
+}
+
+/**
+ * @brief Remove all the samples.
+ * @param samples Samples.
+ */
+static void benchmarkSamplesReset(benchmarkSamples_t *samples)
+{
+    samples->size = 0;
+}
+
+/**
+ * @brief Free the samples.
+ * @param samples Samples.
+ */
+static void benchmarkSamplesFree(benchmarkSamples_t *samples)
+{
+    free(samples->values);
+    samples->values = NULL;
+    samples->size = samples->capacity = 0;
+}
+
+/**
+ * @brief Comparison function of doubles for qsort.
+ * @param a First double.
+ * @param b Second double.
+ * @return Negative, zero or positive if a is less than, equal to or greater than b.
+ */
+static int benchmarkCompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Compute the statistics of the samples: percentiles by nearest rank, 95% confidence interval of the mean
+ *        with the normal approximation.
+ * @param samples Samples (not modified).
+ * @return Statistics; all zero if there are no samples.
+ */
+static benchmarkStats_t benchmarkComputeStats(const benchmarkSamples_t *samples)
+{
+    benchmarkStats_t stats = {0};
+    unsigned int n = samples->size;
+    unsigned int i;
+    double sum = 0, squares = 0, halfWidth;
+    double *sorted;
+    if (n == 0)
+        return stats;
+    sorted = malloc(n * sizeof(double));
+    for (i = 0; i < n; i++)
+    {
+        sorted[i] = samples->values[i];
+        sum += sorted[i];
+    }
+    qsort(sorted, n, sizeof(double), benchmarkCompareDoubles);
+    stats.runs = n;
+    stats.min = sorted[0];
+    stats.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    stats.p90 = sorted[(90 * n + 99) / 100 - 1];
+    stats.p99 = sorted[(99 * n + 99) / 100 - 1];
+    stats.mean = sum / n;
+    for (i = 0; i < n; i++)
+        squares += (sorted[i] - stats.mean) * (sorted[i] - stats.mean);
+    stats.stddev = n > 1 ? sqrt(squares / (n - 1)) : 0;
+    halfWidth = 1.96 * stats.stddev / sqrt(n);
+    stats.ciLow = stats.mean - halfWidth;
+    stats.ciHigh = stats.mean + halfWidth;
+    free(sorted);
+    return stats;
+}
+
+/**
+ * @brief Pin the calling thread to a core, so that migrations do not disturb the measurements.
+ * @param core Core number; a negative value leaves the thread unpinned.
+ * @return true if the thread has been pinned; otherwise, false.
+ */
+static bool benchmarkPinToCore(const int core)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    if (core < 0)
+        return false;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+/**
+ * @brief Open the machine-readable output of the benchmarks (writing the CSV header).
+ * @param fileName Name of the file.
+ * @param format Format of the output.
+ * @return Opened file, or NULL if the format is BENCHMARK_NONE or the file cannot be created.
+ */
+static FILE *benchmarkOpen(const char *fileName, const benchmarkFormat_t format)
+{
+    FILE *file;
+    if (format == BENCHMARK_NONE)
+        return NULL;
+    file = fopen(fileName, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "ERROR: The benchmark output %s has not been created\n", fileName);
+        return NULL;
+    }
+    if (format == BENCHMARK_CSV)
+        fprintf(file, "experiment,series,size,runs,min_ns,median_ns,p90_ns,p99_ns,mean_ns,stddev_ns,ci95_low_ns,ci95_high_ns\n");
+    return file;
+}
+
+/**
+ * @brief Write the statistics of a benchmark to the machine-readable output.
+ * @param file Output opened by benchmarkOpen (nothing is written if NULL).
+ * @param format Format of the output.
+ * @param experiment Name of the experiment (e.g., "sort").
+ * @param series Name of the measured series (e.g., the algorithm).
+ * @param size Size of the input.
+ * @param stats Statistics.
+ */
+static void benchmarkWrite(FILE *file, const benchmarkFormat_t format, const char *experiment, const char *series,
+                           const long long size, const benchmarkStats_t *stats)
+{
+    if (file == NULL)
+        return;
+    if (format == BENCHMARK_CSV)
+        fprintf(file, "%s,%s,%lld,%u,%.0f,%.1f,%.0f,%.0f,%.1f,%.1f,%.1f,%.1f\n", experiment, series, size,
+                stats->runs, stats->min, stats->median, stats->p90, stats->p99, stats->mean, stats->stddev,
+                stats->ciLow, stats->ciHigh);
+    else if (format == BENCHMARK_JSON)
+        fprintf(file,
+                "{\"experiment\":\"%s\",\"series\":\"%s\",\"size\":%lld,\"runs\":%u,\"min_ns\":%.0f,"
+                "\"median_ns\":%.1f,\"p90_ns\":%.0f,\"p99_ns\":%.0f,\"mean_ns\":%.1f,\"stddev_ns\":%.1f,"
+                "\"ci95_low_ns\":%.1f,\"ci95_high_ns\":%.1f}\n",
+                experiment, series, size, stats->runs, stats->min, stats->median, stats->p90, stats->p99,
+                stats->mean, stats->stddev, stats->ciLow, stats->ciHigh);
+}
+
+/**
+ * @brief Close the machine-readable output.
+ * @param file Output opened by benchmarkOpen (ignored if NULL).
+ */
+static void benchmarkClose(FILE *file)
+{
+    if (file != NULL)
+        fclose(file);
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif
@@ -0,0 +1,336 @@
+/**
+ * @brief Runtime parameters shared by the problems of the Laboratory of Algorithms and Data Structures: each
+ *        program lists its tunable globals in a table, and they are set from the command line (--name=value or
+ *        --name value) and from an optional config file (--config=file, one "name = value" for each line).
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+// ##### LIBRARIES ##### //
+
+// Standard input-output library (e.g., fprintf).
+#include <stdio.h>
+// Standard library (e.g., strtoll, exit).
+#include <stdlib.h>
+// Boolean library (e.g., bool).
+#include <stdbool.h>
+// String library (e.g., strcmp).
+#include <string.h>
+// Time library (e.g., time_t).
+#include <time.h>
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+// Maximum number of values of a list option (e.g., the values of m of a matrix).
+#define OPTIONS_MAX_VALUES 64
+// Maximum length of a line of a config file.
+#define OPTIONS_MAX_LINE 1024
+
+/**
+ * @brief Enumeration data type for the type of the global variable set by an option.
+ */
+typedef enum optionType_t
+{
+    OPTION_INT,    // int.
+    OPTION_UINT,   // unsigned int.
+    OPTION_TIME,   // time_t (e.g., a seed).
+    OPTION_DOUBLE, // double.
+    OPTION_BOOL,   // bool: true/false, yes/no, on/off or 1/0 (a flag without value means true).
+    OPTION_STRING, // const char * (pointing to argv or to a copy of the config file value).
+    OPTION_ENUM,   // Enumeration whose values are named by choices, in order.
+    OPTION_LIST    // optionList_t: comma-separated ints (e.g., "1,10,100").
+} optionType_t;
+
+/**
+ * @brief List of ints set by an OPTION_LIST (e.g., the values of m iterated by a matrix run).
+ */
+typedef struct optionList_t
+{
+    // Number of values.
+    int size;
+    // Values.
+    int values[OPTIONS_MAX_VALUES];
+} optionList_t;
+
+/**
+ * @brief Option: name, type and address of the global variable it sets.
+ */
+typedef struct option_t
+{
+    // Name (e.g., "max-size" for --max-size=1000).
+    const char *name;
+    // Type of the variable.
+    optionType_t type;
+    // Address of the variable.
+    void *value;
+    // Description printed by --help.
+    const char *help;
+    // Names of the values of an OPTION_ENUM (NULL-terminated), otherwise NULL.
+    const char *const *choices;
+    // Has the option been given (on the command line or in the config file)?
+    bool given;
+} option_t;
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief Parse an integer in [min, max].
+ * @param text Text.
+ * @param min Minimum value.
+ * @param max Maximum value.
+ * @param value Parsed value (output).
+ * @return true if the whole text is such an integer; otherwise, false.
+ */
+static bool optionsParseInteger(const char *text, const long long min, const long long max, long long *value)
+{
+    char *end;
+    *value = strtoll(text, &end, 0);
+    return *text != '\0' && *end == '\0' && *value >= min && *value <= max;
+}
+
+/**
+ * @brief Set the variable of an option from its textual value.
+ * @param option Option.
+ * @param text Value (NULL for a flag without value).
+ * @return true if the value is valid; otherwise, false (and the variable is unchanged).
+ */
+static bool optionsSetValue(option_t *option, const char *text)
+{
+    long long integer;
+    char *end, *copy, *token;
+    optionList_t list;
+    int i;
+    if (text == NULL && option->type != OPTION_BOOL)
+        return false;
+    switch (option->type)
+    {
+    case OPTION_INT:
+        if (!optionsParseInteger(text, -2147483647LL - 1, 2147483647LL, &integer))
+            return false;
+        *(int *)option->value = (int)integer;
+        break;
+    case OPTION_UINT:
+        if (!optionsParseInteger(text, 0, 4294967295LL, &integer))
+            return false;
+        *(unsigned int *)option->value = (unsigned int)integer;
+        break;
+    case OPTION_TIME:
+        if (!optionsParseInteger(text, 0, 9223372036854775807LL, &integer))
+            return false;
+        *(time_t *)option->value = (time_t)integer;
+        break;
+    case OPTION_DOUBLE:
+        *(double *)option->value = strtod(text, &end);
+        if (*text == '\0' || *end != '\0')
+            return false;
+        break;
+    case OPTION_BOOL:
+        if (text == NULL || !strcmp(text, "true") || !strcmp(text, "yes") || !strcmp(text, "on") || !strcmp(text, "1"))
+            *(bool *)option->value = true;
+        else if (!strcmp(text, "false") || !strcmp(text, "no") || !strcmp(text, "off") || !strcmp(text, "0"))
+            *(bool *)option->value = false;
+        else
+            return false;
+        break;
+    case OPTION_STRING:
+        *(const char **)option->value = text;
+        break;
+    case OPTION_ENUM:
+        for (i = 0; option->choices[i] != NULL && strcmp(option->choices[i], text); i++)
+            ;
+        if (option->choices[i] == NULL)
+            return false;
+        // Enumerations are stored as ints.
+        *(int *)option->value = i;
+        break;
+    case OPTION_LIST:
+        list.size = 0;
+        copy = strdup(text);
+        for (token = strtok(copy, ","); token != NULL; token = strtok(NULL, ","))
+            if (list.size == OPTIONS_MAX_VALUES ||
+                !optionsParseInteger(token, -2147483647LL - 1, 2147483647LL, &integer))
+            {
+                free(copy);
+                return false;
+            }
+            else
+                list.values[list.size++] = (int)integer;
+        free(copy);
+        if (list.size == 0)
+            return false;
+        *(optionList_t *)option->value = list;
+        break;
+    }
+    option->given = true;
+    return true;
+}
+
+/**
+ * @brief Set an option by name.
+ * @param options Options.
+ * @param numOptions Number of options.
+ * @param name Name of the option.
+ * @param text Value (NULL for a flag without value).
+ * @return true if the option exists and the value is valid; otherwise, false (with an error message).
+ */
+static bool optionsSet(option_t *options, const int numOptions, const char *name, const char *text)
+{
+    int i;
+    for (i = 0; i < numOptions; i++)
+        if (!strcmp(options[i].name, name))
+        {
+            if (optionsSetValue(&options[i], text))
+                return true;
+            fprintf(stderr, "ERROR: Invalid value %s for the option %s\n", text == NULL ? "(none)" : text, name);
+            return false;
+        }
+    fprintf(stderr, "ERROR: There is no such option called %s\n", name);
+    return false;
+}
+
+/**
+ * @brief Load a config file: one "name = value" for each line; blank lines and lines starting with # are ignored.
+ * @param options Options.
+ * @param numOptions Number of options.
+ * @param fileName Name of the config file.
+ * @return true if the file has been read and all its options are valid; otherwise, false.
+ */
+static bool optionsLoadFile(option_t *options, const int numOptions, const char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    char line[OPTIONS_MAX_LINE], *name, *text, *end;
+    bool valid = true;
+    if (file == NULL)
+    {
+        fprintf(stderr, "ERROR: The config file %s has not been opened\n", fileName);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        // Trim the line and split it at the first '='.
+        for (name = line; *name == ' ' || *name == '\t'; name++)
+            ;
+        if (*name == '#' || *name == '\n' || *name == '\r' || *name == '\0')
+            continue;
+        text = strchr(name, '=');
+        if (text == NULL)
+        {
+            fprintf(stderr, "ERROR: Missing '=' in the config file %s: %s", fileName, line);
+            valid = false;
+            continue;
+        }
+        for (end = text; end > name && (end[-1] == ' ' || end[-1] == '\t'); end--)
+            ;
+        *end = '\0';
+        for (text++; *text == ' ' || *text == '\t'; text++)
+            ;
+        for (end = text + strlen(text); end > text && strchr(" \t\r\n", end[-1]) != NULL; end--)
+            ;
+        *end = '\0';
+        // The strings must outlive the line.
+        valid = optionsSet(options, numOptions, name, strdup(text)) && valid;
+    }
+    fclose(file);
+    return valid;
+}
+
+/**
+ * @brief Print the usage: the options with their descriptions.
+ * @param file Output.
+ * @param program Name of the program.
+ * @param options Options.
+ * @param numOptions Number of options.
+ */
+static void optionsUsage(FILE *file, const char *program, const option_t *options, const int numOptions)
+{
+    static const char *types[] = {"int", "uint", "int", "real", "bool", "string", "", "int,int,..."};
+    int i, j;
+    fprintf(file, "Usage: %s [--config=file] [--name=value]...\n", program);
+    fprintf(file, "  %-28s %s\n", "--config=file", "Read \"name = value\" lines first (the command line wins)");
+    for (i = 0; i < numOptions; i++)
+    {
+        fprintf(file, "  --%s=", options[i].name);
+        if (options[i].type == OPTION_ENUM)
+            for (j = 0; options[i].choices[j] != NULL; j++)
+                fprintf(file, "%s%s", j > 0 ? "|" : "", options[i].choices[j]);
+        else
+            fprintf(file, "%s", types[options[i].type]);
+        fprintf(file, "\n      %s\n", options[i].help);
+    }
+}
+
+/**
+ * @brief Parse the command line: the config file (if any) is loaded first, then the other options override it.
+ *        The program exits on --help and on invalid options.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @param options Options.
+ * @param numOptions Number of options.
+ */
+static void optionsParse(const int argc, char **argv, option_t *options, const int numOptions)
+{
+    int i;
+    char *name, *text;
+    bool valid = true;
+    for (i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h"))
+        {
+            optionsUsage(stdout, argv[0], options, numOptions);
+            exit(0);
+        }
+        else if (!strncmp(argv[i], "--config=", 9))
+            valid = optionsLoadFile(options, numOptions, argv[i] + 9) && valid;
+        else if (!strcmp(argv[i], "--config") && i + 1 < argc)
+            valid = optionsLoadFile(options, numOptions, argv[++i]) && valid;
+    for (i = 1; i < argc; i++)
+    {
+        if (!strncmp(argv[i], "--config", 8))
+        {
+            i += argv[i][8] == '\0';
+            continue;
+        }
+        if (strncmp(argv[i], "--", 2))
+        {
+            fprintf(stderr, "ERROR: Unexpected argument %s (see --help)\n", argv[i]);
+            valid = false;
+            continue;
+        }
+        name = argv[i] + 2;
+        text = strchr(name, '=');
+        if (text != NULL)
+            *text++ = '\0';
+        // --name value, unless the next argument is another option (e.g., a flag without value).
+        else if (i + 1 < argc && strncmp(argv[i + 1], "--", 2))
+            text = argv[++i];
+        valid = optionsSet(options, numOptions, name, text) && valid;
+    }
+    if (!valid)
+        exit(1);
+}
+
+/**
+ * @brief Has an option been given?
+ * @param options Options.
+ * @param numOptions Number of options.
+ * @param name Name of the option.
+ * @return true if it has been given on the command line or in the config file; otherwise, false.
+ */
+static inline bool optionsGiven(const option_t *options, const int numOptions, const char *name)
+{
+    int i;
+    for (i = 0; i < numOptions; i++)
+        if (!strcmp(options[i].name, name))
+            return options[i].given;
+    return false;
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif
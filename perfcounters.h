@@ -0,0 +1,231 @@
+/**
+ * @brief Hardware performance counters (Linux perf_event_open) shared by the problems of the Laboratory of
+ *        Algorithms and Data Structures: cycles, instructions, branch misses, L1d/LLC misses and dTLB misses of
+ *        a timed region.
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+// ##### LIBRARIES ##### //
+
+// Standard input-output library (e.g., fprintf).
+#include <stdio.h>
+// Boolean library (e.g., bool).
+#include <stdbool.h>
+// String library (e.g., memset).
+#include <string.h>
+// Math library (e.g., NAN, isnan).
+#include <math.h>
+#ifdef __linux__
+// Performance events (e.g., perf_event_attr).
+#include <linux/perf_event.h>
+// System calls (e.g., SYS_perf_event_open).
+#include <sys/syscall.h>
+// Control of devices (e.g., ioctl).
+#include <sys/ioctl.h>
+// POSIX library (e.g., read, close).
+#include <unistd.h>
+#endif
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+// Number of counters.
+#define PERF_NUM_COUNTERS 6
+
+/**
+ * @brief Open counters of the calling thread (a zero-initialized value is closed: starting and stopping it is a
+ *        no-op and every value is unavailable).
+ */
+typedef struct perfCounters_t
+{
+    // Have the counters been opened?
+    bool opened;
+    // File descriptors of the counters (-1 if the counter is unavailable).
+    int fds[PERF_NUM_COUNTERS];
+} perfCounters_t;
+
+/**
+ * @brief Values of the counters (NAN if the counter is unavailable).
+ */
+typedef struct perfValues_t
+{
+    // Values, in the order of perfCounterNames.
+    double values[PERF_NUM_COUNTERS];
+} perfValues_t;
+
+// Names of the counters.
+static const char *perfCounterNames[PERF_NUM_COUNTERS] = {"cycles", "instructions", "branch-misses",
+                                                          "L1d-misses", "LLC-misses", "dTLB-misses"};
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief Open the counters of the calling thread (user space only, initially disabled). Each counter is opened on
+ *        its own, so that the unsupported ones (e.g., in a container or a virtual machine) do not prevent the others.
+ * @param counters Counters.
+ * @return Number of available counters.
+ */
+static int perfCountersOpen(perfCounters_t *counters)
+{
+    int i, available = 0;
+    counters->opened = true;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        counters->fds[i] = -1;
+#ifdef __linux__
+    // Type and configuration of each counter.
+    const unsigned int types[PERF_NUM_COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                   PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+    const unsigned long long configs[PERF_NUM_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+        PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16,
+        PERF_COUNT_HW_CACHE_DTLB | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16};
+    struct perf_event_attr attr;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+    {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Times enabled and running, for scaling the values when the counters are multiplexed.
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        counters->fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fds[i] >= 0)
+            available++;
+    }
+#endif
+    return available;
+}
+
+/**
+ * @brief Reset and start the counters.
+ * @param counters Counters.
+ */
+static void perfCountersStart(const perfCounters_t *counters)
+{
+#ifdef __linux__
+    int i;
+    if (!counters->opened)
+        return;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        if (counters->fds[i] >= 0)
+        {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#else
+    (void)counters;
+#endif
+}
+
+/**
+ * @brief Stop the counters and read their values.
+ * @param counters Counters.
+ * @param values Values counted since perfCountersStart (NAN for the unavailable counters).
+ */
+static void perfCountersStop(const perfCounters_t *counters, perfValues_t *values)
+{
+    int i;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        values->values[i] = NAN;
+#ifdef __linux__
+    // Value, time enabled and time running.
+    unsigned long long data[3];
+    if (!counters->opened)
+        return;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        if (counters->fds[i] >= 0)
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        if (counters->fds[i] >= 0 && read(counters->fds[i], data, sizeof(data)) == sizeof(data) && data[2] > 0)
+            values->values[i] = (double)data[0] * data[1] / data[2];
+#else
+    (void)counters;
+#endif
+}
+
+/**
+ * @brief Close the counters.
+ * @param counters Counters.
+ */
+static void perfCountersClose(perfCounters_t *counters)
+{
+#ifdef __linux__
+    int i;
+    for (i = 0; counters->opened && i < PERF_NUM_COUNTERS; i++)
+        if (counters->fds[i] >= 0)
+            close(counters->fds[i]);
+#endif
+    counters->opened = false;
+}
+
+/**
+ * @brief Set all the values to zero (e.g., before accumulating them with perfValuesAdd).
+ * @param values Values.
+ */
+static void perfValuesReset(perfValues_t *values)
+{
+    int i;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        values->values[i] = 0;
+}
+
+/**
+ * @brief Accumulate values (an unavailable value makes the sum unavailable).
+ * @param sum Accumulated values.
+ * @param values Values to be added.
+ */
+static void perfValuesAdd(perfValues_t *sum, const perfValues_t *values)
+{
+    int i;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        sum->values[i] += values->values[i];
+}
+
+/**
+ * @brief Print the names of the counters as table columns.
+ * @param file Output.
+ * @param prefix String printed before each column (e.g., "\t").
+ * @param suffix String printed after each column (e.g., " |").
+ */
+static void perfHeaderPrint(FILE *file, const char *prefix, const char *suffix)
+{
+    int i;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        fprintf(file, "%s %13s%s", prefix, perfCounterNames[i], suffix);
+}
+
+/**
+ * @brief Print the mean values of the counters as table columns ("n/a" for the unavailable ones).
+ * @param file Output.
+ * @param sum Values accumulated over the runs.
+ * @param runs Number of runs.
+ * @param prefix String printed before each column (e.g., "\t").
+ * @param suffix String printed after each column (e.g., " |").
+ */
+static void perfValuesPrint(FILE *file, const perfValues_t *sum, const unsigned int runs, const char *prefix,
+                            const char *suffix)
+{
+    int i;
+    for (i = 0; i < PERF_NUM_COUNTERS; i++)
+        if (isnan(sum->values[i]) || runs == 0)
+            fprintf(file, "%s %13s%s", prefix, "n/a", suffix);
+        else
+            fprintf(file, "%s %13.0f%s", prefix, sum->values[i] / runs, suffix);
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @brief Pseudo-random number generator shared by the problems of the Laboratory of Algorithms and Data Structures:
+ *        xoshiro256++ with jump-ahead streams (one for each thread), unbiased bounded integers and bulk fill.
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef PRNG_H
+#define PRNG_H
+
+// ##### LIBRARIES ##### //
+
+// Fixed-width integers library (e.g., uint64_t).
+#include <stdint.h>
+// Standard definitions library (e.g., size_t).
+#include <stddef.h>
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+// Number of independent generators interleaved by prngFill (the lanes of its vectorizable loop).
+#define PRNG_LANES 8
+
+/**
+ * @brief State of a xoshiro256++ generator (it must not be all zero: initialize it with prngSeed or
+ *        PRNG_INITIALIZER).
+ */
+typedef struct prng_t
+{
+    // 256 bits of state.
+    uint64_t s[4];
+} prng_t;
+
+// Initializer of a generator equal to prngSeed(g, 0, 0), so that a generator is valid even before being seeded.
+#define PRNG_INITIALIZER {{0xe220a8397b1dcdafull, 0x6e789e6aa1b965f4ull, 0x06c45d188009454full, 0xf88bb8a8724c81ecull}}
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief SplitMix64 step, used for expanding a seed into a full state.
+ * @param x State of SplitMix64 (advanced).
+ * @return Next output of SplitMix64.
+ */
+static inline uint64_t prngSplitMix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Rotate left.
+ * @param x Value.
+ * @param k Number of bits (0 < k < 64).
+ * @return x rotated left by k bits.
+ */
+static inline uint64_t prngRotl(const uint64_t x, const int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Next 64 random bits.
+ * @param g Generator (advanced).
+ * @return Random 64-bit integer.
+ */
+static inline uint64_t prngNext(prng_t *g)
+{
+    const uint64_t result = prngRotl(g->s[0] + g->s[3], 23) + g->s[0];
+    const uint64_t t = g->s[1] << 17;
+    g->s[2] ^= g->s[0];
+    g->s[3] ^= g->s[1];
+    g->s[1] ^= g->s[2];
+    g->s[0] ^= g->s[3];
+    g->s[2] ^= t;
+    g->s[3] = prngRotl(g->s[3], 45);
+    return result;
+}
+
+/**
+ * @brief Jump ahead by 2^128 outputs: 2^128 non-overlapping streams of 2^128 outputs each.
+ * @param g Generator (advanced).
+ */
+static void prngJump(prng_t *g)
+{
+    static const uint64_t jump[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull,
+                                     0x39abdc4529b1661cull};
+    uint64_t s[4] = {0, 0, 0, 0};
+    int i, b;
+    for (i = 0; i < 4; i++)
+        for (b = 0; b < 64; b++)
+        {
+            if (jump[i] & (1ull << b))
+            {
+                s[0] ^= g->s[0];
+                s[1] ^= g->s[1];
+                s[2] ^= g->s[2];
+                s[3] ^= g->s[3];
+            }
+            prngNext(g);
+        }
+    for (i = 0; i < 4; i++)
+        g->s[i] = s[i];
+}
+
+/**
+ * @brief Initialize a generator on a stream of a seed: the same seed and stream always give the same numbers, and
+ *        different streams of the same seed never overlap (e.g., stream i for the thread i).
+ * @param g Generator.
+ * @param seed Seed (e.g., SEED).
+ * @param stream Stream number (the generator jumps ahead stream times).
+ */
+static void prngSeed(prng_t *g, const uint64_t seed, const unsigned int stream)
+{
+    uint64_t x = seed;
+    unsigned int i;
+    for (i = 0; i < 4; i++)
+        g->s[i] = prngSplitMix64(&x);
+    for (i = 0; i < stream; i++)
+        prngJump(g);
+}
+
+/**
+ * @brief Unbiased random integer in [0, bound) by multiplication and rejection (Lemire), without divisions in the
+ *        common case.
+ * @param g Generator (advanced).
+ * @param bound Upper bound (excluded), greater than 0.
+ * @return Random integer in [0, bound).
+ */
+static inline uint32_t prngBounded(prng_t *g, const uint32_t bound)
+{
+    uint64_t m = (prngNext(g) >> 32) * bound;
+    uint32_t low = (uint32_t)m, threshold;
+    if (low < bound)
+    {
+        threshold = -bound % bound;
+        while (low < threshold)
+        {
+            m = (prngNext(g) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return m >> 32;
+}
+
+/**
+ * @brief Fill an array with random integers in [offset, offset + bound). PRNG_LANES generators seeded from g run
+ *        interleaved, so the loop has no dependency between consecutive elements and can be vectorized; each
+ *        integer is the high part of a 64x32-bit product, whose bias (at most bound / 2^64) is negligible.
+ * @param g Generator (advanced).
+ * @param A Array.
+ * @param n Size of the array.
+ * @param bound Number of distinct values, greater than 0.
+ * @param offset Smallest value.
+ */
+static void prngFill(prng_t *g, int *A, const size_t n, const uint32_t bound, const int offset)
+{
+    uint64_t s0[PRNG_LANES], s1[PRNG_LANES], s2[PRNG_LANES], s3[PRNG_LANES], x, t, r;
+    size_t i;
+    int l;
+    // Few elements: the lanes are not worth their seeding.
+    if (n < 4 * PRNG_LANES)
+    {
+        for (i = 0; i < n; i++)
+            A[i] = offset + (int)prngBounded(g, bound);
+        return;
+    }
+    for (l = 0; l < PRNG_LANES; l++)
+    {
+        x = prngNext(g);
+        s0[l] = prngSplitMix64(&x);
+        s1[l] = prngSplitMix64(&x);
+        s2[l] = prngSplitMix64(&x);
+        s3[l] = prngSplitMix64(&x);
+    }
+    for (i = 0; i + PRNG_LANES <= n; i += PRNG_LANES)
+        for (l = 0; l < PRNG_LANES; l++)
+        {
+            r = prngRotl(s0[l] + s3[l], 23) + s0[l];
+            t = s1[l] << 17;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = prngRotl(s3[l], 45);
+            // floor(r * bound / 2^64) with 32x32-bit products only.
+            A[i + l] = offset + (int)(((r >> 32) * bound + (((r & 0xffffffffull) * bound) >> 32)) >> 32);
+        }
+    for (; i < n; i++)
+        A[i] = offset + (int)prngBounded(g, bound);
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @brief Parallel experiment runner shared by the problems of the Laboratory of Algorithms and Data Structures:
+ *        independent jobs (e.g., the repetitions of an experiment for a size) spread over pinned worker threads, with
+ *        one random stream for each job, so that the results do not depend on the number of threads.
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef RUNNER_H
+#define RUNNER_H
+
+// ##### LIBRARIES ##### //
+
+// Standard input-output library (e.g., fopen).
+#include <stdio.h>
+// Standard library (e.g., malloc).
+#include <stdlib.h>
+// Boolean library (e.g., bool).
+#include <stdbool.h>
+// POSIX threads library (e.g., pthread_create).
+#include <pthread.h>
+// Atomic operations library (e.g., atomic_fetch_add).
+#include <stdatomic.h>
+// Scheduling library (e.g., sched_getaffinity); it needs _GNU_SOURCE defined before the first include.
+#include <sched.h>
+// Pseudo-random number generator (e.g., prngSeed).
+#include "prng.h"
+// Benchmark harness (e.g., benchmarkPinToCore).
+#include "benchmark.h"
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+// Maximum number of cores the workers can be pinned to.
+#define RUNNER_MAX_CORES 1024
+
+/**
+ * @brief Runner: number of workers and cores they are pinned to.
+ */
+typedef struct runner_t
+{
+    // Number of worker threads (1: the jobs run in order on the calling thread).
+    int numThreads;
+    // Cores the workers are pinned to, round robin (none: the workers are not pinned).
+    int cores[RUNNER_MAX_CORES];
+    // Number of cores.
+    int numCores;
+    // Function called by each worker before its first job (e.g., opening its counters), or NULL.
+    void (*threadStart)(void);
+    // Function called by each worker after its last job (e.g., closing its counters), or NULL.
+    void (*threadEnd)(void);
+} runner_t;
+
+/**
+ * @brief Worker of a run: it takes the next job until there are none left.
+ */
+typedef struct runnerWorker_t
+{
+    // Runner.
+    const runner_t *runner;
+    // Job function, called with the context and the index of the job.
+    void (*job)(void *, int);
+    // Context of the jobs (e.g., inputs and per-job result slots).
+    void *context;
+    // Number of jobs.
+    int numJobs;
+    // Next job to be taken, shared by the workers.
+    atomic_int *nextJob;
+    // Core of the worker (negative: not pinned).
+    int core;
+} runnerWorker_t;
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief Cores isolated from the scheduler (isolcpus= boot parameter), read from
+ *        /sys/devices/system/cpu/isolated (e.g., "2-3,6").
+ * @param cores Cores (output).
+ * @param max Maximum number of cores.
+ * @return Number of isolated cores (0 if there are none or the list cannot be read).
+ */
+static int runnerIsolatedCores(int *cores, const int max)
+{
+    FILE *file = fopen("/sys/devices/system/cpu/isolated", "r");
+    int n = 0, first, last, c;
+    char separator;
+    if (file == NULL)
+        return 0;
+    while (n < max && fscanf(file, "%d", &first) == 1)
+    {
+        last = first;
+        separator = (char)fgetc(file);
+        if (separator == '-')
+        {
+            if (fscanf(file, "%d", &last) != 1)
+                break;
+            separator = (char)fgetc(file);
+        }
+        for (c = first; c <= last && n < max; c++)
+            cores[n++] = c;
+        if (separator != ',')
+            break;
+    }
+    fclose(file);
+    return n;
+}
+
+/**
+ * @brief Cores the process is allowed to run on.
+ * @param cores Cores (output).
+ * @param max Maximum number of cores.
+ * @return Number of cores (0 if they cannot be read).
+ */
+static int runnerAllowedCores(int *cores, const int max)
+{
+    int n = 0;
+#ifdef __linux__
+    cpu_set_t set;
+    int c;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return 0;
+    for (c = 0; c < CPU_SETSIZE && n < max; c++)
+        if (CPU_ISSET(c, &set))
+            cores[n++] = c;
+#else
+    (void)cores;
+    (void)max;
+#endif
+    return n;
+}
+
+/**
+ * @brief Initialize a runner.
+ * @param runner Runner.
+ * @param threads Number of worker threads: 1 runs the jobs in order on the calling thread (no pinning), a
+ *                non-positive value means one for each selected core.
+ * @param isolatedOnly Pin the workers to the isolated cores only (at most one worker for each of them), so that
+ *                     the timings are not disturbed by other processes; if there are none, all the allowed cores are
+ *                     used.
+ * @param threadStart Function called by each worker before its first job, or NULL.
+ * @param threadEnd Function called by each worker after its last job, or NULL.
+ */
+static void runnerInit(runner_t *runner, const int threads, const bool isolatedOnly, void (*threadStart)(void),
+                       void (*threadEnd)(void))
+{
+    runner->numCores = 0;
+    if (isolatedOnly)
+    {
+        runner->numCores = runnerIsolatedCores(runner->cores, RUNNER_MAX_CORES);
+        if (runner->numCores == 0)
+            fprintf(stderr, "ERROR: There are no isolated cores, the experiments run on all the allowed cores\n");
+    }
+    if (runner->numCores == 0)
+        runner->numCores = runnerAllowedCores(runner->cores, RUNNER_MAX_CORES);
+    runner->numThreads = threads;
+    if (runner->numThreads <= 0 || (isolatedOnly && runner->numCores > 0 && runner->numThreads > runner->numCores))
+        runner->numThreads = runner->numCores > 0 ? runner->numCores : 1;
+    runner->threadStart = threadStart;
+    runner->threadEnd = threadEnd;
+}
+
+/**
+ * @brief Seed the generator of a job: each job has its own stream, which depends only on the seed and on the
+ *        index of the job (not on the thread running it), so that any number of threads gives the same inputs as
+ *        the serial order.
+ * @param g Generator.
+ * @param seed Seed of the experiment (e.g., SEED).
+ * @param job Index of the job, unique within the experiment.
+ */
+static void runnerSeedJob(prng_t *g, const uint64_t seed, const uint64_t job)
+{
+    // SplitMix64 is a bijection, so that different jobs get different seeds.
+    uint64_t x = seed + 0x632be59bd9b4e019ull * (job + 1);
+    prngSeed(g, prngSplitMix64(&x), 0);
+}
+
+/**
+ * @brief Body of a worker thread.
+ * @param argument Worker (runnerWorker_t).
+ * @return NULL.
+ */
+static void *runnerWorker(void *argument)
+{
+    runnerWorker_t *worker = argument;
+    int job;
+    if (worker->core >= 0)
+        benchmarkPinToCore(worker->core);
+    if (worker->runner->threadStart != NULL)
+        worker->runner->threadStart();
+    while ((job = atomic_fetch_add(worker->nextJob, 1)) < worker->numJobs)
+        worker->job(worker->context, job);
+    if (worker->runner->threadEnd != NULL)
+        worker->runner->threadEnd();
+    return NULL;
+}
+
+/**
+ * @brief Run the jobs 0..numJobs-1 and wait for all of them. Each job must write its results only to its own slots
+ *        of the context, so that reading them in the order of the jobs gives the results of the serial order.
+ * @param runner Runner.
+ * @param numJobs Number of jobs.
+ * @param job Job function, called with the context and the index of the job.
+ * @param context Context of the jobs.
+ */
+static void runnerRun(const runner_t *runner, const int numJobs, void (*job)(void *, int), void *context)
+{
+    runnerWorker_t *workers;
+    pthread_t *ids;
+    atomic_int nextJob;
+    int t, threads = runner->numThreads < numJobs ? runner->numThreads : numJobs;
+    // Serial order on the calling thread.
+    if (threads <= 1)
+    {
+        for (t = 0; t < numJobs; t++)
+            job(context, t);
+        return;
+    }
+    atomic_init(&nextJob, 0);
+    workers = malloc(threads * sizeof(runnerWorker_t));
+    ids = malloc(threads * sizeof(pthread_t));
+    for (t = 0; t < threads; t++)
+    {
+        workers[t].runner = runner;
+        workers[t].job = job;
+        workers[t].context = context;
+        workers[t].numJobs = numJobs;
+        workers[t].nextJob = &nextJob;
+        workers[t].core = runner->numCores > 0 ? runner->cores[t % runner->numCores] : -1;
+        pthread_create(&ids[t], NULL, runnerWorker, &workers[t]);
+    }
+    for (t = 0; t < threads; t++)
+        pthread_join(ids[t], NULL);
+    free(ids);
+    free(workers);
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif
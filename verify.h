@@ -0,0 +1,289 @@
+/**
+ * @brief Verification of the outputs shared by the problems of the Laboratory of Algorithms and Data Structures:
+ *        sortedness check with shifted vector loads and an order-independent hash of the multiset of the elements,
+ *        both split among threads on large arrays.
+ * @author Marchiori Luca
+ * @version Student
+ */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+// ##### LIBRARIES ##### //
+
+// Standard library (e.g., malloc).
+#include <stdlib.h>
+// Boolean library (e.g., bool).
+#include <stdbool.h>
+// Fixed-width integers library (e.g., uint64_t).
+#include <stdint.h>
+// POSIX threads library (e.g., pthread_create).
+#include <pthread.h>
+// POSIX library (e.g., sysconf).
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+// Intel intrinsics (e.g., _mm256_cmpgt_epi32).
+#include <immintrin.h>
+#endif
+
+// ##### End of LIBRARIES ##### //
+
+// ##### DATA STRUCTURES ##### //
+
+// Size from which the checks are split among threads (smaller arrays are checked faster by the calling thread).
+#define VERIFY_PARALLEL_THRESHOLD (1 << 20)
+// Number of elements between two tests of the early exit of the vectorized sortedness check.
+#define VERIFY_BLOCK 64
+
+/**
+ * @brief Chunk of an array checked by a thread.
+ */
+typedef struct verifyChunk_t
+{
+    // First element of the chunk.
+    const int *A;
+    // Size of the chunk.
+    size_t n;
+    // Is the chunk sorted? (Output of verifyIsSortedWorker.)
+    bool sorted;
+    // Hash of the multiset of the chunk. (Output of verifyHashWorker.)
+    uint64_t hash;
+} verifyChunk_t;
+
+// ##### End of DATA STRUCTURES ##### //
+
+// ##### IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+/**
+ * @brief Scalar sortedness check.
+ * @param A Array.
+ * @param n Size of the array.
+ * @return true if A[i] <= A[i+1] for every i; otherwise, false.
+ */
+static bool verifyIsSortedScalar(const int *A, const size_t n)
+{
+    size_t i;
+    for (i = 1; i < n; i++)
+        if (A[i - 1] > A[i])
+            return false;
+    return true;
+}
+
+/**
+ * @brief Bijective mix of a 32-bit integer (odd multiplications and xorshifts), so that replacing an element by a
+ *        different one always changes its contribution to the hash.
+ * @param x Integer.
+ * @return Mixed integer.
+ */
+static inline uint32_t verifyMix(const uint32_t x)
+{
+    uint32_t h = x * 0x9e3779b1u;
+    h ^= h >> 15;
+    h *= 0x85ebca77u;
+    h ^= h >> 13;
+    return h;
+}
+
+/**
+ * @brief Scalar hash of the multiset of the elements: sum of their mixes in 64 bits (without overflow below 2^32
+ *        elements), so that it does not depend on the order of the elements.
+ * @param A Array.
+ * @param n Size of the array.
+ * @return Hash.
+ */
+static uint64_t verifyHashScalar(const int *A, const size_t n)
+{
+    uint64_t hash = 0;
+    size_t i;
+    for (i = 0; i < n; i++)
+        hash += verifyMix((uint32_t)A[i]);
+    return hash;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief AVX2 sortedness check: A[i..i+7] and A[i+1..i+8] are compared lane by lane, and the violations are
+ *        accumulated and tested once every VERIFY_BLOCK elements.
+ * @param A Array.
+ * @param n Size of the array.
+ * @return true if A[i] <= A[i+1] for every i; otherwise, false.
+ */
+__attribute__((target("avx2"))) static bool verifyIsSortedAvx2(const int *A, const size_t n)
+{
+    __m256i violations = _mm256_setzero_si256();
+    size_t i = 0, j;
+    while (i + VERIFY_BLOCK + 1 <= n)
+    {
+        for (j = i; j < i + VERIFY_BLOCK; j += 8)
+            violations = _mm256_or_si256(violations, _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(A + j)),
+                                                                        _mm256_loadu_si256((const __m256i *)(A + j + 1))));
+        if (!_mm256_testz_si256(violations, violations))
+            return false;
+        i += VERIFY_BLOCK;
+    }
+    return verifyIsSortedScalar(A + i, n - i);
+}
+
+/**
+ * @brief AVX2 hash of the multiset of the elements (the same value as verifyHashScalar): eight 32-bit mixes at a
+ *        time, widened and accumulated in four 64-bit lanes.
+ * @param A Array.
+ * @param n Size of the array.
+ * @return Hash.
+ */
+__attribute__((target("avx2"))) static uint64_t verifyHashAvx2(const int *A, const size_t n)
+{
+    const __m256i k1 = _mm256_set1_epi32((int)0x9e3779b1u), k2 = _mm256_set1_epi32((int)0x85ebca77u);
+    __m256i sum = _mm256_setzero_si256(), h;
+    uint64_t lanes[4];
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        h = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(A + i)), k1);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+        h = _mm256_mullo_epi32(h, k2);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(h)));
+        sum = _mm256_add_epi64(sum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(h, 1)));
+    }
+    _mm256_storeu_si256((__m256i *)lanes, sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + verifyHashScalar(A + i, n - i);
+}
+#endif
+
+/**
+ * @brief Does the CPU support AVX2? (Checked once at runtime.)
+ * @return true if it does; otherwise, false.
+ */
+static bool verifyHasAvx2()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static int supported = -1;
+    if (supported < 0)
+        supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Sortedness check of a chunk with the best available kernel.
+ * @param argument Chunk (verifyChunk_t), whose last element is compared with the first one of the next chunk.
+ * @return NULL.
+ */
+static void *verifyIsSortedWorker(void *argument)
+{
+    verifyChunk_t *chunk = argument;
+#if defined(__x86_64__) || defined(__i386__)
+    if (verifyHasAvx2())
+    {
+        chunk->sorted = verifyIsSortedAvx2(chunk->A, chunk->n);
+        return NULL;
+    }
+#endif
+    chunk->sorted = verifyIsSortedScalar(chunk->A, chunk->n);
+    return NULL;
+}
+
+/**
+ * @brief Multiset hash of a chunk with the best available kernel.
+ * @param argument Chunk (verifyChunk_t).
+ * @return NULL.
+ */
+static void *verifyHashWorker(void *argument)
+{
+    verifyChunk_t *chunk = argument;
+#if defined(__x86_64__) || defined(__i386__)
+    if (verifyHasAvx2())
+    {
+        chunk->hash = verifyHashAvx2(chunk->A, chunk->n);
+        return NULL;
+    }
+#endif
+    chunk->hash = verifyHashScalar(chunk->A, chunk->n);
+    return NULL;
+}
+
+/**
+ * @brief Run a worker on contiguous chunks of an array, one for each thread (the calling thread takes the first one).
+ * @param A Array.
+ * @param n Size of the array.
+ * @param threads Number of threads; a non-positive value means one for each online core. Arrays smaller than
+ *                VERIFY_PARALLEL_THRESHOLD are checked by the calling thread only.
+ * @param overlap Number of elements each chunk shares with the next one (e.g., 1 for comparing neighbours).
+ * @param worker Worker (verifyIsSortedWorker or verifyHashWorker).
+ * @param numChunks Number of chunks (output).
+ * @return Checked chunks, to be freed by the caller.
+ */
+static verifyChunk_t *verifyRun(const int *A, const size_t n, int threads, const size_t overlap,
+                                void *(*worker)(void *), int *numChunks)
+{
+    verifyChunk_t *chunks;
+    pthread_t *ids;
+    size_t size, start;
+    int t;
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < VERIFY_PARALLEL_THRESHOLD || threads < 1)
+        threads = 1;
+    size = (n + threads - 1) / threads;
+    chunks = malloc(threads * sizeof(verifyChunk_t));
+    ids = malloc(threads * sizeof(pthread_t));
+    for (t = 0; t < threads; t++)
+    {
+        start = t * size < n ? t * size : n;
+        chunks[t].A = A + start;
+        chunks[t].n = start + size + overlap < n ? size + overlap : n - start;
+    }
+    for (t = 1; t < threads; t++)
+        pthread_create(&ids[t], NULL, worker, &chunks[t]);
+    worker(&chunks[0]);
+    for (t = 1; t < threads; t++)
+        pthread_join(ids[t], NULL);
+    free(ids);
+    *numChunks = threads;
+    return chunks;
+}
+
+/**
+ * @brief Check if an array is sorted (vectorized, and split among threads on large arrays).
+ * @param A Array.
+ * @param n Size of the array.
+ * @param threads Number of threads; a non-positive value means one for each online core.
+ * @return true if it is sorted; otherwise, false.
+ */
+static inline bool verifyIsSorted(const int *A, const size_t n, const int threads)
+{
+    int numChunks, t;
+    bool sorted = true;
+    verifyChunk_t *chunks = verifyRun(A, n, threads, 1, verifyIsSortedWorker, &numChunks);
+    for (t = 0; t < numChunks; t++)
+        sorted = sorted && chunks[t].sorted;
+    free(chunks);
+    return sorted;
+}
+
+/**
+ * @brief Order-independent hash of the multiset of the elements of an array (vectorized, and split among threads on
+ *        large arrays): a sort must preserve it, so a lost or duplicated element is detected even if the output is
+ *        sorted.
+ * @param A Array.
+ * @param n Size of the array.
+ * @param threads Number of threads; a non-positive value means one for each online core.
+ * @return Hash.
+ */
+static inline uint64_t verifyMultisetHash(const int *A, const size_t n, const int threads)
+{
+    int numChunks, t;
+    uint64_t hash = 0;
+    verifyChunk_t *chunks = verifyRun(A, n, threads, 0, verifyHashWorker, &numChunks);
+    for (t = 0; t < numChunks; t++)
+        hash += chunks[t].hash;
+    free(chunks);
+    return hash;
+}
+
+// ##### End of IMPLEMENTATION OF THE FUNCTIONS ##### //
+
+#endif